@@ -0,0 +1,27 @@
+// Counting replacement for the global operator new/delete. Not part of
+// yotsuiro_core: any object using new would pull it out of the library, so it
+// is added only to the bench and, with YOTSUIRO_PROFILING, to the hook DLL.
+#include "common.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<uint64_t> g_total{0};
+    thread_local uint32_t t_count = 0;
+}
+
+namespace AllocCount {
+    uint32_t Thread() { return t_count; }
+    uint64_t Total() { return g_total.load(std::memory_order_relaxed); }
+}
+
+void* operator new(size_t size) {
+    t_count++;
+    g_total.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
@@ -0,0 +1,269 @@
+#include "common.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//=============================================================================
+// Configuration
+//=============================================================================
+namespace Config {
+    // Runtime file paths (configurable via INI)
+    char translationFile[MAX_PATH] = ".\\tl\\translation.tsv";
+    char namesFile[MAX_PATH] = ".\\tl\\unique_names.tsv";
+    char charIdFile[MAX_PATH] = ".\\tl\\char_table.tsv";
+    char configFile[MAX_PATH] = ".\\yotsuiro_tl.ini";
+    char untranslatedLog[MAX_PATH] = ".\\tl\\untranslated.tsv";
+    bool useBinaryCache = true;
+
+    // General
+    char windowTitle[256] = "";
+    bool enableConsole = true;
+    bool enableTextLogging = true;
+    bool dumpUntranslated = false;
+    bool enableDiscordPresence = true;
+    uint32_t logCategories = 0xFFFFFFFF;  // LogCategory bits, see [General] LogCategories
+    char logFile[MAX_PATH] = "";          // Also write the log here (empty = console only)
+
+    // Text
+    int wordWrapWidth = 70;
+
+    // Hotkeys
+    int reloadHotkey = VK_F5;
+    int statsHotkey = VK_F6;
+    int logToggleHotkey = VK_F7;
+
+    // Font
+    char fontName[64] = "";
+    char fontNameProportional[64] = "";
+
+    // Asset redirection
+    bool enableAssetRedirect = true;
+    bool logAssetRedirects = false;
+    char tlAssetsPath[MAX_PATH] = ".\\tl\\assets\\";
+    char assetCachePath[MAX_PATH] = ".\\tl\\cache\\";  // PNG overrides transcoded to GYU
+
+    // Debug
+    bool enableDebugMode = false;
+    bool enableGameDebugOutput = false;
+    bool enableProfiling = false;
+}
+
+//=============================================================================
+// Logging
+//=============================================================================
+// Hooks never touch the console: Log() formats into a slot of a lock-free
+// ring (bounded MPMC sequence queue) and a writer thread does the slow I/O.
+FILE* g_logFile = nullptr;
+FILE* g_logTeeFile = nullptr;
+
+namespace AsyncLog {
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        uint32_t length;
+        char text[Constants::kLogSlotSize];
+    };
+
+    static Slot g_slots[Constants::kLogSlotCount];
+    static std::atomic<uint32_t> g_head{0};   // Next position producers claim
+    static uint32_t g_tail = 0;               // Next position to drain (under g_drainMutex)
+    static std::atomic<uint32_t> g_dropped{0};
+    static std::atomic<bool> g_active{false};
+    static std::atomic<bool> g_writerIdle{false};
+    static std::atomic<bool> g_stopping{false};
+    static std::mutex g_drainMutex;
+    static HANDLE g_wakeEvent = nullptr;
+    static HANDLE g_writerThread = nullptr;
+
+    static void Push(const char* fmt, va_list args) {
+        uint32_t pos = g_head.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &g_slots[pos & (Constants::kLogSlotCount - 1)];
+            uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(sequence - pos);
+            if (diff == 0) {
+                if (g_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                g_dropped.fetch_add(1, std::memory_order_relaxed);  // Full - never block the game
+                return;
+            } else {
+                pos = g_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        int length = vsnprintf(slot->text, sizeof(slot->text), fmt, args);
+        if (length < 0) length = 0;
+        if ((size_t)length >= sizeof(slot->text)) {
+            length = (int)sizeof(slot->text) - 1;
+            slot->text[length - 1] = '\n';  // Truncated - keep records line-terminated
+        }
+        slot->length = (uint32_t)length;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        if (g_writerIdle.exchange(false, std::memory_order_acq_rel)) {
+            SetEvent(g_wakeEvent);
+        }
+    }
+
+    static void Write(const char* text, size_t length) {
+        if (g_logFile) fwrite(text, 1, length, g_logFile);
+        if (g_logTeeFile) fwrite(text, 1, length, g_logTeeFile);
+    }
+
+    // Write out everything published so far; returns false if there was nothing
+    static bool Drain() {
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+
+        bool wrote = false;
+        for (;;) {
+            Slot& slot = g_slots[g_tail & (Constants::kLogSlotCount - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != g_tail + 1) break;
+
+            Write(slot.text, slot.length);
+            slot.sequence.store(g_tail + (uint32_t)Constants::kLogSlotCount, std::memory_order_release);
+            g_tail++;
+            wrote = true;
+        }
+
+        uint32_t dropped = g_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped) {
+            char note[64];
+            int length = sprintf_s(note, "[LOG] %u messages dropped (ring full)\n", dropped);
+            if (length > 0) Write(note, (size_t)length);
+            wrote = true;
+        }
+
+        if (wrote) {
+            if (g_logFile) fflush(g_logFile);
+            if (g_logTeeFile) fflush(g_logTeeFile);
+        }
+        return wrote;
+    }
+
+    static DWORD WINAPI WriterThreadProc(LPVOID) {
+        while (!g_stopping.load(std::memory_order_acquire)) {
+            if (Drain()) continue;
+
+            // Announce we're idle, then re-check so a record pushed in between isn't missed
+            g_writerIdle.store(true, std::memory_order_release);
+            if (Drain()) {
+                g_writerIdle.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            WaitForSingleObject(g_wakeEvent, Constants::kLogIdleWaitMs);
+        }
+        return 0;
+    }
+
+    // Producers can fill the ring before there is a writer; Start() drains it.
+    // Lines past its capacity only count as dropped, they never block.
+    void Buffer() {
+        if (g_active.load(std::memory_order_relaxed)) return;
+        for (uint32_t i = 0; i < Constants::kLogSlotCount; i++) {
+            g_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        g_active.store(true, std::memory_order_release);
+    }
+
+    void Start() {
+        Buffer();
+        g_wakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        g_writerThread = CreateThread(nullptr, 0, WriterThreadProc, nullptr, 0, nullptr);
+        SetEvent(g_wakeEvent);  // Anything buffered so far
+    }
+
+    // Flush synchronously - safe from DllMain, unlike waiting on the writer
+    void Stop() {
+        if (!g_active.exchange(false)) return;
+        g_stopping.store(true, std::memory_order_release);
+        if (g_wakeEvent) SetEvent(g_wakeEvent);
+        Drain();
+    }
+
+    void CloseSinks() {
+        if (g_writerThread) {
+            WaitForSingleObject(g_writerThread, 1000);
+            CloseHandle(g_writerThread);
+            g_writerThread = nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        if (g_logTeeFile) {
+            fclose(g_logTeeFile);
+            g_logTeeFile = nullptr;
+        }
+        if (g_logFile) {
+            fclose(g_logFile);
+            g_logFile = nullptr;
+        }
+    }
+}
+
+void Log(const char* fmt, ...) {
+    if (!AsyncLog::g_active.load(std::memory_order_acquire)) return;
+    va_list args;
+    va_start(args, fmt);
+    AsyncLog::Push(fmt, args);
+    va_end(args);
+}
+
+void Log(LogCategory category, const char* fmt, ...) {
+    if (!LogEnabled(category) || !AsyncLog::g_active.load(std::memory_order_acquire)) return;
+    va_list args;
+    va_start(args, fmt);
+    AsyncLog::Push(fmt, args);
+    va_end(args);
+}
+
+//=============================================================================
+// Parallel Loops
+//=============================================================================
+namespace {
+    // Shared with the helpers, which may only get to run after the loop is done
+    struct ParallelJob {
+        std::atomic<size_t> next{0};
+        size_t count = 0;
+        size_t done = 0;
+        const std::function<void(size_t)>* fn = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        // Returns once no unclaimed items are left
+        void Work() {
+            for (;;) {
+                size_t i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= count) return;
+                (*fn)(i);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++done == count) finished.notify_all();
+            }
+        }
+    };
+}
+
+void ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+
+    size_t cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+    size_t helpers = (std::min)(cores, count) - 1;
+    if (helpers == 0) {
+        for (size_t i = 0; i < count; i++) fn(i);
+        return;
+    }
+
+    auto job = std::make_shared<ParallelJob>();
+    job->count = count;
+    job->fn = &fn;
+    for (size_t i = 0; i < helpers; i++) {
+        std::thread([job] { job->Work(); }).detach();
+    }
+
+    job->Work();
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&] { return job->done == job->count; });
+}
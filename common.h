@@ -0,0 +1,203 @@
+#pragma once
+// Constants, configuration and logging shared by the hook DLL and the tools
+// built on yotsuiro_core
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+//=============================================================================
+// Constants
+//=============================================================================
+namespace Constants {
+    constexpr int kMaxSearchResults = 20;
+    constexpr DWORD kFileWatcherDebounceMs = 100;
+    constexpr DWORD kDiscordCallbackIntervalMs = 10000;
+    constexpr DWORD kDiscordPresenceIntervalMs = 15000;  // Discord drops updates sent faster
+    constexpr int kMaxMissedTextsToShow = 15;
+    constexpr DWORD kMissDumpBatchMs = 1000;  // Misses collected before one write to untranslated.tsv
+    constexpr size_t kStringPoolChunkSize = 64 * 1024;
+    constexpr size_t kStringPoolGenerationBytes = 4 * 1024 * 1024;  // Start a new generation past this
+    constexpr int kStringPoolRetireScenes = 2;  // Scene loads a retired generation must outlive
+    constexpr size_t kLogSlotCount = 1024;      // Records the log ring can hold (power of two)
+    constexpr size_t kLogSlotSize = 512;        // Bytes per record, longer lines are truncated
+    constexpr DWORD kLogIdleWaitMs = 100;
+    constexpr DWORD kTranslationsWaitMs = 15000;  // Longest a hook holds text for the initial load
+    constexpr DWORD kReclaimRetryMs = 10;  // Service thread retry while retired snapshots are still pinned
+    constexpr size_t kParallelParseChunk = 256 * 1024;  // Smallest TSV chunk worth a thread
+    constexpr size_t kGlyphCacheEntries = 4096;
+    constexpr size_t kGlyphCacheBytes = 8 * 1024 * 1024;  // Outline/bitmap data kept across all glyphs
+    constexpr size_t kFontCacheEntries = 32;     // Distinct fonts kept alive for reuse
+    constexpr int kPrewarmFontHeight = 24;
+}
+
+//=============================================================================
+// Configuration
+//=============================================================================
+namespace Config {
+    // Default file paths (relative to game executable)
+    constexpr const char* kDefaultTranslationFile = ".\\tl\\translation.tsv";
+    constexpr const char* kDefaultNamesFile = ".\\tl\\unique_names.tsv";
+    constexpr const char* kDefaultCharIdFile = ".\\tl\\char_table.tsv";
+    constexpr const char* kDefaultTlAssetsPath = ".\\tl\\assets\\";
+    constexpr const char* kDefaultAssetCachePath = ".\\tl\\cache\\";
+
+    // Runtime file paths (configurable via INI)
+    extern char translationFile[MAX_PATH];
+    extern char namesFile[MAX_PATH];
+    extern char charIdFile[MAX_PATH];
+    extern char configFile[MAX_PATH];
+    extern char untranslatedLog[MAX_PATH];
+    extern bool useBinaryCache;
+
+    // General
+    extern char windowTitle[256];
+    extern bool enableConsole;
+    extern bool enableTextLogging;
+    extern bool dumpUntranslated;
+    extern bool enableDiscordPresence;
+    extern uint32_t logCategories;  // LogCategory bits, see [General] LogCategories
+    extern char logFile[MAX_PATH];  // Also write the log here (empty = console only)
+
+    // Text
+    extern int wordWrapWidth;
+
+    // Hotkeys
+    extern int reloadHotkey;
+    extern int statsHotkey;
+    extern int logToggleHotkey;
+
+    // Font
+    extern char fontName[64];
+    extern char fontNameProportional[64];
+
+    // Asset redirection
+    extern bool enableAssetRedirect;
+    extern bool logAssetRedirects;
+    extern char tlAssetsPath[MAX_PATH];
+    extern char assetCachePath[MAX_PATH];  // PNG overrides transcoded to GYU
+
+    // Debug
+    extern bool enableDebugMode;
+    extern bool enableGameDebugOutput;
+    extern bool enableProfiling;
+}
+
+//=============================================================================
+// Logging
+//=============================================================================
+// Optional log channels, filtered before anything is formatted
+enum class LogCategory : uint32_t {
+    Say   = 1 << 0,  // Dialogue and choices (also needs EnableTextLogging)
+    Scene = 1 << 1,
+    Asset = 1 << 2,
+    Font  = 1 << 3,
+    Save  = 1 << 4,
+};
+
+// Queue a line for the writer thread; never blocks on I/O
+void Log(const char* fmt, ...);
+void Log(LogCategory category, const char* fmt, ...);
+
+inline bool LogEnabled(LogCategory category) {
+    if (category == LogCategory::Say && !Config::enableTextLogging) return false;
+    return (Config::logCategories & (uint32_t)category) != 0;
+}
+
+// Sinks the writer thread drains into; open them before AsyncLog::Start()
+extern FILE* g_logFile;
+extern FILE* g_logTeeFile;
+
+namespace AsyncLog {
+    void Buffer();      // Keep lines logged before Start(), up to the ring's size - safe from DllMain
+    void Start();
+    void Stop();        // Flushes synchronously - safe from DllMain
+    void CloseSinks();  // After Stop(): waits for the writer, then closes both sinks
+}
+
+//=============================================================================
+// Allocation Counting
+//=============================================================================
+// operator new calls in the module, for modules built with alloc_count.cpp -
+// the bench, and the hook DLL with YOTSUIRO_PROFILING
+namespace AllocCount {
+    uint32_t Thread();  // On the calling thread
+    uint64_t Total();   // On every thread
+}
+
+//=============================================================================
+// Hashing
+//=============================================================================
+// FNV-1a; chain calls to hash several pieces as one, starting from kHashSeed
+constexpr uint64_t kHashSeed = 0xCBF29CE484222325ull;
+
+inline uint64_t HashBytes(uint64_t hash, std::string_view bytes) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+//=============================================================================
+// Parallel Loops
+//=============================================================================
+// Run fn(0..count-1) on the calling thread plus helper threads. The caller
+// claims items too and only waits for ones a helper has already started, so
+// this never deadlocks where new threads can't run yet (DllMain) - it just
+// does all the work itself there.
+void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+//=============================================================================
+// Engine RNG
+//=============================================================================
+// MT19937 with the engine's seeding - keys GYU scrambling and RLD encryption
+class MersenneTwister {
+public:
+    explicit MersenneTwister(uint32_t seed) {
+        uint32_t a = seed;
+        for (int i = 0; i < kStateSize; i++) {
+            uint32_t value = a & 0xFFFF0000;
+            a = 69069 * a + 1;
+            value |= a >> 16;
+            m_state[i] = value;
+            a = 69069 * a + 1;
+        }
+        Twist();
+    }
+
+    uint32_t Next() {
+        if (m_index >= kStateSize) Twist();
+        uint32_t y = m_state[m_index++];
+        y ^= y >> 11;
+        y ^= (y << 7) & 0x9D2C5680;
+        y ^= (y << 15) & 0xEFC60000;
+        y ^= y >> 18;
+        return y;
+    }
+
+    uint32_t Rand(uint32_t max) { return max ? Next() % max : 0; }
+
+private:
+    static constexpr int kStateSize = 624;
+
+    static uint32_t Mix(uint32_t upper, uint32_t lower, uint32_t far) {
+        uint32_t y = (upper & 0x80000000) | (lower & 0x7FFFFFFF);
+        return far ^ (y >> 1) ^ ((y & 1) ? 0x9908B0DF : 0);
+    }
+
+    void Twist() {
+        for (int i = 0; i < 227; i++) m_state[i] = Mix(m_state[i], m_state[i + 1], m_state[i + 397]);
+        for (int i = 227; i < 623; i++) m_state[i] = Mix(m_state[i], m_state[i + 1], m_state[i - 227]);
+        m_state[623] = Mix(m_state[623], m_state[0], m_state[396]);
+        m_index = 0;
+    }
+
+    uint32_t m_state[kStateSize];
+    int m_index = kStateSize;
+};
@@ -1,25 +1,36 @@
 ﻿#define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <objbase.h>
+#include <wincodec.h>
 #include <Psapi.h>
 #include <cstdio>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <map>
+#include <list>
+#include <deque>
 #include <fstream>
 #include <mutex>
 #include <vector>
+#include <algorithm>
 #include <functional>
+#include <memory>
 #include <atomic>
 #include <chrono> 
 #include <MinHook.h>
 #include <discord_rpc.h>
 #include "proxy.h"
+#include "common.h"
+#include "text.h"
+#include "translation_db.h"
 
 #pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "ole32.lib")
+#pragma comment(lib, "windowscodecs.lib")
 
 //=============================================================================
 // Function Offsets (ImageBase 0x10000000)
@@ -37,63 +48,6 @@ namespace Offsets {
     constexpr uintptr_t GetCodePage      = 0x00137030;
 }
 
-//=============================================================================
-// Constants
-//=============================================================================
-namespace Constants {
-    constexpr int kMaxLabelSuffixSearch = 30;
-    constexpr int kMaxSearchResults = 20;
-    constexpr DWORD kHotkeyPollIntervalMs = 50;
-    constexpr DWORD kFileWatcherDebounceMs = 100;
-    constexpr int kMaxMissedTextsToShow = 15;
-}
-
-//=============================================================================
-// Configuration
-//=============================================================================
-namespace Config {
-    // Default file paths (relative to game executable)
-    constexpr const char* kDefaultTranslationFile = ".\\tl\\translation.tsv";
-    constexpr const char* kDefaultNamesFile = ".\\tl\\unique_names.tsv";
-    constexpr const char* kDefaultCharIdFile = ".\\tl\\char_table.tsv";
-    constexpr const char* kDefaultTlAssetsPath = ".\\tl\\assets\\";
-
-    // Runtime file paths (configurable via INI)
-    char translationFile[MAX_PATH] = ".\\tl\\translation.tsv";
-    char namesFile[MAX_PATH] = ".\\tl\\unique_names.tsv";
-    char charIdFile[MAX_PATH] = ".\\tl\\char_table.tsv";
-    char configFile[MAX_PATH] = ".\\yotsuiro_tl.ini";
-    char untranslatedLog[MAX_PATH] = ".\\tl\\untranslated.tsv";
-
-    // General
-    char windowTitle[256] = "";
-    bool enableConsole = true;
-    bool enableTextLogging = true;
-    bool dumpUntranslated = false;
-    bool enableDiscordPresence = true;
-
-    // Text
-    int wordWrapWidth = 70;
-
-    // Hotkeys
-    int reloadHotkey = VK_F5;
-    int statsHotkey = VK_F6;
-    int logToggleHotkey = VK_F7;
-
-    // Font
-    char fontName[64] = "";
-    char fontNameProportional[64] = "";
-
-    // Asset redirection
-    bool enableAssetRedirect = true;
-    bool logAssetRedirects = false;
-    char tlAssetsPath[MAX_PATH] = ".\\tl\\assets\\";
-
-    // Debug
-    bool enableDebugMode = false;
-    bool enableGameDebugOutput = false;
-}
-
 //=============================================================================
 // Config Save/Load
 //=============================================================================
@@ -115,6 +69,12 @@ static void SaveDefaultConfig() {
     fprintf(f, "; Log text to console\n");
     fprintf(f, "EnableTextLogging=true\n");
     fprintf(f, "\n");
+    fprintf(f, "; Log categories to show (any of SAY, SCENE, ASSET, FONT, SAVE - SAVE traces save slot titles)\n");
+    fprintf(f, "LogCategories=SAY,SCENE,ASSET,FONT\n");
+    fprintf(f, "\n");
+    fprintf(f, "; Also write the log to this file (empty = console only)\n");
+    fprintf(f, "LogFile=\n");
+    fprintf(f, "\n");
     fprintf(f, "; Dump untranslated text to file\n");
     fprintf(f, "DumpUntranslated=false\n");
     fprintf(f, "\n");
@@ -148,6 +108,9 @@ static void SaveDefaultConfig() {
     fprintf(f, "NamesFile=.\\tl\\unique_names.tsv\n");
     fprintf(f, "CharIdFile=.\\tl\\char_table.tsv\n");
     fprintf(f, "\n");
+    fprintf(f, "; Cache the parsed translation file as <TranslationFile>.bin for faster startup\n");
+    fprintf(f, "UseBinaryCache=true\n");
+    fprintf(f, "\n");
 
     fprintf(f, "[Assets]\n");
     fprintf(f, "; Enable asset redirection from tl/assets folder\n");
@@ -159,6 +122,9 @@ static void SaveDefaultConfig() {
     fprintf(f, "; Path to replacement assets (supports .gyu and .png)\n");
     fprintf(f, "Path=.\\tl\\assets\\\n");
     fprintf(f, "\n");
+    fprintf(f, "; Where .png replacements are converted to .gyu (once per PNG content)\n");
+    fprintf(f, "CachePath=.\\tl\\cache\\\n");
+    fprintf(f, "\n");
 
 
     fprintf(f, "[Debug]\n");
@@ -168,6 +134,9 @@ static void SaveDefaultConfig() {
     fprintf(f, "; Show game's internal debug output in console\n");
     fprintf(f, "EnableGameDebugOutput=false\n");
     fprintf(f, "\n");
+    fprintf(f, "; Time the text, font and file hooks (see the 'perf' console command; needs a YOTSUIRO_PROFILING build)\n");
+    fprintf(f, "Profile=false\n");
+    fprintf(f, "\n");
 
     fclose(f);
 }
@@ -192,8 +161,32 @@ static void ReadString(const char* section, const char* key, const char* default
     GetPrivateProfileStringA(section, key, defaultVal, out, (DWORD)outSize, Config::configFile);
 }
 
-// Forward declaration for Log (defined later)
-static void Log(const char* fmt, ...);
+// "SAY,SCENE" -> bits; unknown names are ignored
+static uint32_t ParseLogCategories(const char* list) {
+    static const struct { const char* name; LogCategory category; } kNames[] = {
+        { "SAY", LogCategory::Say },
+        { "SCENE", LogCategory::Scene },
+        { "ASSET", LogCategory::Asset },
+        { "FONT", LogCategory::Font },
+        { "SAVE", LogCategory::Save },
+    };
+
+    uint32_t mask = 0;
+    std::string token;
+    for (const char* p = list; ; p++) {
+        if (*p == ',' || *p == '\0') {
+            while (!token.empty() && token.back() == ' ') token.pop_back();
+            for (const auto& entry : kNames) {
+                if (_stricmp(token.c_str(), entry.name) == 0) mask |= (uint32_t)entry.category;
+            }
+            token.clear();
+            if (*p == '\0') break;
+        } else if (*p != ' ' || !token.empty()) {
+            token += *p;
+        }
+    }
+    return mask;
+}
 
 //=============================================================================
 // Debug Scene Jump
@@ -220,6 +213,10 @@ static void LoadConfig() {
     Config::enableTextLogging = ReadBool("General", "EnableTextLogging", true);
     Config::dumpUntranslated = ReadBool("General", "DumpUntranslated", false);
     Config::enableDiscordPresence = ReadBool("General", "EnableDiscordPresence", true);
+    char categories[128];
+    ReadString("General", "LogCategories", "SAY,SCENE,ASSET,FONT", categories, sizeof(categories));
+    Config::logCategories = ParseLogCategories(categories);
+    ReadString("General", "LogFile", "", Config::logFile, sizeof(Config::logFile));
 
     // Text
     Config::wordWrapWidth = ReadInt("Text", "WordWrapWidth", 70);
@@ -237,24 +234,31 @@ static void LoadConfig() {
     ReadString("Files", "TranslationFile", Config::kDefaultTranslationFile, Config::translationFile, sizeof(Config::translationFile));
     ReadString("Files", "NamesFile", Config::kDefaultNamesFile, Config::namesFile, sizeof(Config::namesFile));
     ReadString("Files", "CharIdFile", Config::kDefaultCharIdFile, Config::charIdFile, sizeof(Config::charIdFile));
+    Config::useBinaryCache = ReadBool("Files", "UseBinaryCache", true);
 
     // Asset Redirection
     Config::enableAssetRedirect = ReadBool("Assets", "EnableRedirect", true);
     Config::logAssetRedirects = ReadBool("Assets", "LogRedirects", false);
     ReadString("Assets", "Path", Config::kDefaultTlAssetsPath, Config::tlAssetsPath, sizeof(Config::tlAssetsPath));
+    ReadString("Assets", "CachePath", Config::kDefaultAssetCachePath, Config::assetCachePath, sizeof(Config::assetCachePath));
 
     // Debug
     Config::enableDebugMode = ReadBool("Debug", "EnableDebugMode", false);
     Config::enableGameDebugOutput = ReadBool("Debug", "EnableGameDebugOutput", false);
+    Config::enableProfiling = ReadBool("Debug", "Profile", false);
 
     // Initialize debug state from config
     DebugJump::g_debugModeActive = Config::enableGameDebugOutput;
 
-    // Ensure path ends with backslash
+    // Ensure paths end with backslash
     size_t len = strlen(Config::tlAssetsPath);
     if (len > 0 && Config::tlAssetsPath[len - 1] != '\\') {
         strcat_s(Config::tlAssetsPath, "\\");
     }
+    len = strlen(Config::assetCachePath);
+    if (len > 0 && Config::assetCachePath[len - 1] != '\\') {
+        strcat_s(Config::assetCachePath, "\\");
+    }
 
     // Log
     Log("[CONFIG] Loaded from %s\n", Config::configFile);
@@ -269,9 +273,20 @@ static void LoadConfig() {
 
 static std::atomic<bool> g_discordRunning{false};
 static bool g_presenceTimerSet = false;
-static std::string g_currentChapter = "Loading...";
 static std::chrono::steady_clock::time_point g_presenceStartTime;
 
+// Presence mailbox: hooks post the newest chapter id, the service thread sends
+// it when Discord's rate limit allows, so a fast skip costs one IPC call
+static constexpr uint32_t kNoChapter = UINT32_MAX;
+static std::mutex g_chapterMutex;
+static std::vector<std::string> g_chapterNames = { "Loading..." };  // Id -> name, append-only
+static std::unordered_map<std::string, uint32_t> g_chapterIds = { { "Loading...", 0 } };
+static std::atomic<uint32_t> g_postedChapter{0};
+static HANDLE g_presenceEvent = nullptr;      // Wakes the service thread on a new post
+static uint32_t g_sentChapter = kNoChapter;   // Service thread only
+static ULONGLONG g_lastPresenceTime = 0;
+static ULONGLONG g_nextCallbacksTime = 0;
+
 static const char* DISCORD_CLIENT_ID = "1466328361583251488";
 
 static void OnDiscordReady(const DiscordUser* connectedUser) {
@@ -287,12 +302,12 @@ static void OnDiscordError(int errcode, const char* message) {
     Log("[Discord] Error (%d): %s\n", errcode, message);
 }
 
-static void UpdateDiscordPresence() {
+static void UpdateDiscordPresence(const char* chapter) {
     if (!Config::enableDiscordPresence || !g_discordRunning) return;
 
     DiscordRichPresence rp = {};
     rp.state          = "";
-    rp.details        = g_currentChapter.c_str();
+    rp.details        = chapter;
     rp.largeImageKey  = "icon";
     rp.largeImageText = "";
     // Optional: rp.smallImageKey = "playing"; etc.
@@ -307,12 +322,34 @@ static void UpdateDiscordPresence() {
     Discord_UpdatePresence(&rp);
 }
 
-static void DiscordUpdateThread() {
-    while (g_discordRunning) {
+// Service thread: runs callbacks every kDiscordCallbackIntervalMs and sends the
+// newest posted chapter at most once per kDiscordPresenceIntervalMs.
+// Returns the tick at which it next needs to run.
+static ULONGLONG PumpDiscord(ULONGLONG now) {
+    if (now >= g_nextCallbacksTime) {
         Discord_RunCallbacks();
-        UpdateDiscordPresence();
-        std::this_thread::sleep_for(std::chrono::seconds(10));
+        g_nextCallbacksTime = now + Constants::kDiscordCallbackIntervalMs;
+    }
+
+    ULONGLONG next = g_nextCallbacksTime;
+    uint32_t posted = g_postedChapter.load(std::memory_order_acquire);
+    if (posted != g_sentChapter) {
+        ULONGLONG allowed = g_lastPresenceTime ? g_lastPresenceTime + Constants::kDiscordPresenceIntervalMs : 0;
+        if (now >= allowed) {
+            std::string chapter;
+            {
+                std::lock_guard<std::mutex> lock(g_chapterMutex);
+                chapter = g_chapterNames[posted];
+            }
+            UpdateDiscordPresence(chapter.c_str());
+            Log("[Discord] Updated chapter: %s\n", chapter.c_str());
+            g_sentChapter = posted;
+            g_lastPresenceTime = now;
+        } else {
+            next = (std::min)(next, allowed);
+        }
     }
+    return next;
 }
 
 static void InitDiscordRPC() {
@@ -323,13 +360,11 @@ static void InitDiscordRPC() {
 
     Discord_Initialize(DISCORD_CLIENT_ID, &handlers, 1, nullptr);
     g_presenceStartTime = std::chrono::steady_clock::now();
+    g_presenceEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
     g_discordRunning = true;
 
-    std::thread(DiscordUpdateThread).detach();
-
-    // Initial presence
-    g_currentChapter = "Loading...";
-    UpdateDiscordPresence();
+    // Whatever was posted before we got here ("Loading..." by default) goes out with the first pump
+    g_sentChapter = kNoChapter;
 }
 
 static void ShutdownDiscordRPC() {
@@ -340,23 +375,31 @@ static void ShutdownDiscordRPC() {
     Discord_Shutdown();
 }
 
-// Call this whenever chapter/label changes
+// Call this whenever chapter/label changes - only posts, never talks to Discord
 void UpdateChapterPresence(const std::string& chapterName) {
-    if (!Config::enableDiscordPresence) return;
+    if (!Config::enableDiscordPresence || chapterName.empty()) return;
 
-    if (chapterName.empty() || chapterName == g_currentChapter) return;
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(g_chapterMutex);
+        auto it = g_chapterIds.find(chapterName);
+        if (it != g_chapterIds.end()) {
+            id = it->second;
+        } else {
+            id = (uint32_t)g_chapterNames.size();
+            g_chapterNames.push_back(chapterName);
+            g_chapterIds.emplace(chapterName, id);
+        }
+    }
 
-    g_currentChapter = chapterName;
-    Log("[Discord] Updated chapter: %s\n", chapterName.c_str());
-    UpdateDiscordPresence();
+    if (g_postedChapter.exchange(id, std::memory_order_release) != id && g_presenceEvent) {
+        SetEvent(g_presenceEvent);
+    }
 }
 
 //=============================================================================
 // Logging
 //=============================================================================
-static FILE* g_logFile = nullptr;
-static std::mutex g_logMutex;
-
 static void InitConsole() {
     if (!Config::enableConsole) return;
     AllocConsole();
@@ -377,869 +420,865 @@ static void InitConsole() {
     setvbuf(stdout, nullptr, _IONBF, 0);
 }
 
-static void Log(const char* fmt, ...) {
-    if (!g_logFile) return;
-    std::lock_guard<std::mutex> lock(g_logMutex);
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(g_logFile, fmt, args);
-    va_end(args);
-    fflush(g_logFile);
+// Open the sinks chosen in the config and start the writer thread
+static void InitLogging() {
+    InitConsole();
+
+    if (Config::logFile[0]) {
+        if (fopen_s(&g_logTeeFile, Config::logFile, "ab") != 0) {
+            g_logTeeFile = nullptr;
+        }
+    }
+
+    if (g_logFile || g_logTeeFile) {
+        AsyncLog::Start();
+    } else {
+        AsyncLog::Stop();  // Nowhere to write - drop what DllMain buffered
+    }
 }
 
 //=============================================================================
-// Encoding Detection & Conversion
-//=============================================================================
-namespace Encoding {
-    enum class Type {
-        Unknown,
-        UTF8_BOM,
-        UTF8,
-        ShiftJIS
+// Hook Profiling
+//=============================================================================
+// [Debug] Profile=true times the hot hooks with QueryPerformanceCounter. Each
+// thread records into its own log-linear (HDR-style, ~12% wide) histograms,
+// so recording is a few relaxed stores; the 'perf' command sums the threads.
+// The timers and the allocation counter only exist in a YOTSUIRO_PROFILING
+// build; there, Profile=false leaves each scope one branch on a config flag.
+namespace Perf {
+    enum Probe : int {
+        kAdvCharSay,
+        kPrintEx,
+        kSaveDataTitle,
+        kCreateFileA,
+        kGetGlyphOutlineA,
+        kCreateFontIndirectA,
+        kProbeCount
     };
 
-    // Detect encoding of a buffer
-    Type Detect(const char* data, size_t size) {
-        if (size == 0) return Type::Unknown;
+    static const char* const kProbeNames[kProbeCount] = {
+        "AdvCharSay", "PrintEx", "SaveDataTitle", "CreateFileA", "GetGlyphOutlineA", "CreateFontIndirectA",
+    };
 
-        // Check for UTF-8 BOM
-        if (size >= 3 &&
-            (unsigned char)data[0] == 0xEF &&
-            (unsigned char)data[1] == 0xBB &&
-            (unsigned char)data[2] == 0xBF) {
-            return Type::UTF8_BOM;
-        }
+    // 0-15 ns exact, then 8 sub-buckets per power of two up to ~2^40 ns
+    constexpr int kLinearBuckets = 16;
+    constexpr int kSubBuckets = 8;
+    constexpr int kBucketCount = kLinearBuckets + (40 - 4) * kSubBuckets;
 
-        // Try to detect UTF-8 by looking for valid multi-byte sequences
-        int utf8Score = 0;
-        int sjisScore = 0;
+    static int BucketOf(uint64_t ns) {
+        if (ns < kLinearBuckets) return (int)ns;
+        int exponent = 63;
+        while (!(ns >> exponent)) exponent--;
+        int bucket = kLinearBuckets + (exponent - 4) * kSubBuckets + (int)((ns >> (exponent - 3)) & (kSubBuckets - 1));
+        return (std::min)(bucket, kBucketCount - 1);
+    }
 
-        for (size_t i = 0; i < size && i < 1000; i++) {
-            unsigned char c = (unsigned char)data[i];
+    // Largest value that lands in the bucket - percentiles never under-report
+    static uint64_t BucketLimit(int bucket) {
+        if (bucket < kLinearBuckets) return (uint64_t)bucket;
+        int exponent = (bucket - kLinearBuckets) / kSubBuckets + 4;
+        uint64_t sub = (uint64_t)((bucket - kLinearBuckets) % kSubBuckets);
+        return ((kSubBuckets + sub + 1) << (exponent - 3)) - 1;
+    }
 
-            // UTF-8 multi-byte detection
-            if (c >= 0xC0 && c <= 0xDF && i + 1 < size) {
-                unsigned char c2 = (unsigned char)data[i + 1];
-                if (c2 >= 0x80 && c2 <= 0xBF) {
-                    utf8Score += 2;
-                    i++;
-                    continue;
-                }
-            }
-            if (c >= 0xE0 && c <= 0xEF && i + 2 < size) {
-                unsigned char c2 = (unsigned char)data[i + 1];
-                unsigned char c3 = (unsigned char)data[i + 2];
-                if (c2 >= 0x80 && c2 <= 0xBF && c3 >= 0x80 && c3 <= 0xBF) {
-                    utf8Score += 3;
-                    i += 2;
-                    continue;
-                }
-            }
+    // Written by one thread, read by the 'perf' command
+    struct Histogram {
+        std::atomic<uint32_t> buckets[kBucketCount];
+        std::atomic<uint64_t> max;
 
-            // Shift-JIS detection (common Japanese ranges)
-            if ((c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC)) {
-                if (i + 1 < size) {
-                    unsigned char c2 = (unsigned char)data[i + 1];
-                    if ((c2 >= 0x40 && c2 <= 0x7E) || (c2 >= 0x80 && c2 <= 0xFC)) {
-                        sjisScore += 2;
-                        i++;
-                        continue;
-                    }
-                }
-            }
+        void Record(uint64_t ns) {
+            std::atomic<uint32_t>& bucket = buckets[BucketOf(ns)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (ns > max.load(std::memory_order_relaxed)) max.store(ns, std::memory_order_relaxed);
         }
+    };
 
-        if (utf8Score > sjisScore * 2) return Type::UTF8;
-        if (sjisScore > 0) return Type::ShiftJIS;
-        return Type::UTF8;  // Default to UTF-8 for ASCII-only
-    }
+    struct ProbeStats {
+        std::atomic<uint32_t> calls;
+        std::atomic<uint64_t> ownNs;       // Inside the hook, minus the original function
+        std::atomic<uint64_t> originalNs;
+        std::atomic<uint64_t> allocations; // operator new calls on our side
+        Histogram own;
+        Histogram total;
+    };
 
-    // Shift-JIS -> UTF-8
-    std::string SjisToUtf8(const char* sjis) {
-        if (!sjis || !*sjis) return "";
+    struct ThreadStats {
+        ProbeStats probes[kProbeCount];
+    };
 
-        int wideLen = MultiByteToWideChar(932, 0, sjis, -1, nullptr, 0);
-        if (wideLen <= 0) return "";
+    // Threads are never unregistered, so counts from exited threads still show
+    static std::vector<std::unique_ptr<ThreadStats>> g_threads;
+    static std::mutex g_threadsMutex;
+    static uint64_t g_frequency = 0;
 
-        std::wstring wide(wideLen, 0);
-        MultiByteToWideChar(932, 0, sjis, -1, &wide[0], wideLen);
+    static void Init() {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        g_frequency = (uint64_t)frequency.QuadPart;
+    }
 
-        int utf8Len = WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), -1, nullptr, 0, nullptr, nullptr);
-        if (utf8Len <= 0) return "";
+    static ThreadStats& Local() {
+        static thread_local ThreadStats* t_stats = nullptr;
+        if (!t_stats) {
+            auto stats = std::make_unique<ThreadStats>();  // Value-initialized: all zero
+            t_stats = stats.get();
+            std::lock_guard<std::mutex> lock(g_threadsMutex);
+            g_threads.push_back(std::move(stats));
+        }
+        return *t_stats;
+    }
 
-        std::string utf8(utf8Len, 0);
-        WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), -1, &utf8[0], utf8Len, nullptr, nullptr);
+    static uint64_t Now() {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return (uint64_t)counter.QuadPart;
+    }
 
-        if (!utf8.empty() && utf8.back() == 0) utf8.pop_back();
-        return utf8;
+    static uint64_t ToNs(uint64_t ticks) {
+        return g_frequency ? ticks * 1000000000ull / g_frequency : 0;
     }
 
-    // UTF-8 -> Shift-JIS
-    std::string Utf8ToSjis(const char* utf8) {
-        if (!utf8 || !*utf8) return "";
+#ifdef YOTSUIRO_PROFILING
+    // Times a hook from construction to destruction; wrap the call to the
+    // original in Original() so the game's own time is kept apart
+    class Scope {
+    public:
+        explicit Scope(Probe probe) : m_probe(probe) {
+            if (!Config::enableProfiling) return;
+            m_allocations = AllocCount::Thread();
+            m_start = Now();
+        }
+
+        ~Scope() {
+            if (!m_start) return;
+            uint64_t total = ToNs(Now() - m_start);
+            uint64_t original = ToNs(m_originalTicks);
+            uint64_t own = (total > original) ? total - original : 0;
 
-        int wideLen = MultiByteToWideChar(CP_UTF8, 0, utf8, -1, nullptr, 0);
-        if (wideLen <= 0) return "";
+            ProbeStats& stats = Local().probes[m_probe];
+            stats.calls.store(stats.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            stats.ownNs.store(stats.ownNs.load(std::memory_order_relaxed) + own, std::memory_order_relaxed);
+            stats.originalNs.store(stats.originalNs.load(std::memory_order_relaxed) + original, std::memory_order_relaxed);
+            stats.allocations.store(stats.allocations.load(std::memory_order_relaxed) +
+                (AllocCount::Thread() - m_allocations), std::memory_order_relaxed);
+            stats.own.Record(own);
+            stats.total.Record(total);
+        }
 
-        std::wstring wide(wideLen, 0);
-        MultiByteToWideChar(CP_UTF8, 0, utf8, -1, &wide[0], wideLen);
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
 
-        int sjisLen = WideCharToMultiByte(932, 0, wide.c_str(), -1, nullptr, 0, nullptr, nullptr);
-        if (sjisLen <= 0) return "";
+        template <typename Fn>
+        auto Original(Fn fn) -> decltype(fn()) {
+            OriginalTimer timer(*this);
+            return fn();
+        }
 
-        std::string sjis(sjisLen, 0);
-        WideCharToMultiByte(932, 0, wide.c_str(), -1, &sjis[0], sjisLen, nullptr, nullptr);
+    private:
+        struct OriginalTimer {
+            explicit OriginalTimer(Scope& owner) : scope(owner), start(owner.m_start ? Now() : 0) {}
+            ~OriginalTimer() { if (start) scope.m_originalTicks += Now() - start; }
+            Scope& scope;
+            uint64_t start;
+        };
 
-        if (!sjis.empty() && sjis.back() == 0) sjis.pop_back();
-        return sjis;
-    }
+        Probe m_probe;
+        uint64_t m_start = 0;
+        uint64_t m_originalTicks = 0;
+        uint32_t m_allocations = 0;
+    };
+#else
+    // Compiled out - the hooks keep their scopes and pay nothing for them
+    class Scope {
+    public:
+        explicit Scope(Probe) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        template <typename Fn>
+        auto Original(Fn fn) -> decltype(fn()) { return fn(); }
+    };
+#endif
+
+    // One probe summed over every thread
+    struct Summary {
+        uint64_t calls = 0;
+        uint64_t ownNs = 0;
+        uint64_t originalNs = 0;
+        uint64_t allocations = 0;
+        uint64_t own[kBucketCount] = {};
+        uint64_t total[kBucketCount] = {};
+        uint64_t ownMax = 0;
+        uint64_t totalMax = 0;
+    };
 
-    // Convert any encoding to UTF-8
-    std::string ToUtf8(const std::string& data, Type encoding) {
-        switch (encoding) {
-        case Type::UTF8_BOM:
-            return data.size() >= 3 ? data.substr(3) : data;
-        case Type::UTF8:
-            return data;
-        case Type::ShiftJIS:
-            return SjisToUtf8(data.c_str());
-        default:
-            return data;
+    static void Summarize(Summary summaries[kProbeCount]) {
+        std::lock_guard<std::mutex> lock(g_threadsMutex);
+        for (const auto& thread : g_threads) {
+            for (int p = 0; p < kProbeCount; p++) {
+                const ProbeStats& stats = thread->probes[p];
+                Summary& summary = summaries[p];
+                summary.calls += stats.calls.load(std::memory_order_relaxed);
+                summary.ownNs += stats.ownNs.load(std::memory_order_relaxed);
+                summary.originalNs += stats.originalNs.load(std::memory_order_relaxed);
+                summary.allocations += stats.allocations.load(std::memory_order_relaxed);
+                for (int b = 0; b < kBucketCount; b++) {
+                    summary.own[b] += stats.own.buckets[b].load(std::memory_order_relaxed);
+                    summary.total[b] += stats.total.buckets[b].load(std::memory_order_relaxed);
+                }
+                summary.ownMax = (std::max)(summary.ownMax, stats.own.max.load(std::memory_order_relaxed));
+                summary.totalMax = (std::max)(summary.totalMax, stats.total.max.load(std::memory_order_relaxed));
+            }
         }
     }
-}
-
-//=============================================================================
-// Asset Redirection
-//=============================================================================
-namespace AssetRedirect {
 
-    static std::string GetFileName(const std::string& path) {
-        size_t pos = path.find_last_of("\\/");
-        return (pos != std::string::npos) ? path.substr(pos + 1) : path;
-    }
+    static uint64_t Percentile(const uint64_t buckets[kBucketCount], double fraction) {
+        uint64_t count = 0;
+        for (int b = 0; b < kBucketCount; b++) count += buckets[b];
+        if (count == 0) return 0;
 
-    static std::string GetRelativePath(const std::string& fullPath) {
-        // Look for "res\" in the path
-        size_t resPos = fullPath.find("res\\");
-        if (resPos != std::string::npos) {
-            return fullPath.substr(resPos + 4);
+        uint64_t rank = (uint64_t)(fraction * (double)(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < kBucketCount; b++) {
+            seen += buckets[b];
+            if (seen >= rank) return BucketLimit(b);
         }
-        return GetFileName(fullPath);
+        return BucketLimit(kBucketCount - 1);
     }
 
-    static std::string FindReplacement(const std::string& originalPath) {
-        if (!Config::enableAssetRedirect) return "";
+    static double Us(uint64_t ns) { return (double)ns / 1000.0; }
 
-        std::string relativePath = GetRelativePath(originalPath);
-        std::string assetsPath = Config::tlAssetsPath;
+    static void Print() {
+        std::unique_ptr<Summary[]> summaries(new Summary[kProbeCount]);
+        Summarize(summaries.get());
 
-        // Try 1: Exact path (tl/assets/g/ev/xxx.gyu)
-        std::string tryPath = assetsPath + relativePath;
-        if (::FileExists(tryPath.c_str())) {
-            return tryPath;
+        Log("\n========== Hook Timing (us) ==========\n");
+        Log("  %-20s %9s %8s %8s %9s %8s %8s %6s %8s\n",
+            "hook", "calls", "own p50", "own p99", "own max", "all p50", "all p99", "own%", "allocs");
+        for (int p = 0; p < kProbeCount; p++) {
+            const Summary& s = summaries[p];
+            if (s.calls == 0) continue;
+            uint64_t spent = s.ownNs + s.originalNs;
+            Log("  %-20s %9llu %8.1f %8.1f %9.1f %8.1f %8.1f %5.1f%% %8.2f\n",
+                kProbeNames[p], (unsigned long long)s.calls,
+                Us(Percentile(s.own, 0.50)), Us(Percentile(s.own, 0.99)), Us(s.ownMax),
+                Us(Percentile(s.total, 0.50)), Us(Percentile(s.total, 0.99)),
+                spent ? 100.0 * (double)s.ownNs / (double)spent : 0.0,
+                (double)s.allocations / (double)s.calls);
         }
+        Log("  own = our code, all = including the original function; allocs per call\n");
+        Log("=======================================\n\n");
+    }
 
-        // Try 2: PNG version of exact path
-        size_t extPos = tryPath.rfind(".gyu");
-        if (extPos != std::string::npos) {
-            std::string pngPath = tryPath.substr(0, extPos) + ".png";
-            if (::FileExists(pngPath.c_str())) {
-                return pngPath;
-            }
-        }
+    static bool WriteCsv(const char* path) {
+        std::unique_ptr<Summary[]> summaries(new Summary[kProbeCount]);
+        Summarize(summaries.get());
 
-        // Try 3: Flat structure (tl/assets/xxx.gyu)
-        std::string filename = GetFileName(originalPath);
-        tryPath = assetsPath + filename;
-        if (::FileExists(tryPath.c_str())) {
-            return tryPath;
+        FILE* f = nullptr;
+        if (fopen_s(&f, path, "w") != 0 || !f) return false;
+
+        fprintf(f, "hook,calls,own_p50_us,own_p99_us,own_max_us,total_p50_us,total_p99_us,total_max_us,"
+            "own_total_ms,original_total_ms,allocs_per_call\n");
+        for (int p = 0; p < kProbeCount; p++) {
+            const Summary& s = summaries[p];
+            fprintf(f, "%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                kProbeNames[p], (unsigned long long)s.calls,
+                Us(Percentile(s.own, 0.50)), Us(Percentile(s.own, 0.99)), Us(s.ownMax),
+                Us(Percentile(s.total, 0.50)), Us(Percentile(s.total, 0.99)), Us(s.totalMax),
+                (double)s.ownNs / 1e6, (double)s.originalNs / 1e6,
+                s.calls ? (double)s.allocations / (double)s.calls : 0.0);
         }
+        fclose(f);
+        return true;
+    }
 
-        // Try 4: Flat PNG (tl/assets/xxx.png)
-        extPos = filename.rfind(".gyu");
-        if (extPos != std::string::npos) {
-            std::string pngName = filename.substr(0, extPos) + ".png";
-            tryPath = assetsPath + pngName;
-            if (::FileExists(tryPath.c_str())) {
-                return tryPath;
+    // Owners may be recording meanwhile; a count lost to the race doesn't matter here
+    static void Reset() {
+        std::lock_guard<std::mutex> lock(g_threadsMutex);
+        for (const auto& thread : g_threads) {
+            for (auto& stats : thread->probes) {
+                stats.calls.store(0, std::memory_order_relaxed);
+                stats.ownNs.store(0, std::memory_order_relaxed);
+                stats.originalNs.store(0, std::memory_order_relaxed);
+                stats.allocations.store(0, std::memory_order_relaxed);
+                for (auto* histogram : { &stats.own, &stats.total }) {
+                    for (auto& bucket : histogram->buckets) bucket.store(0, std::memory_order_relaxed);
+                    histogram->max.store(0, std::memory_order_relaxed);
+                }
             }
         }
-
-        return "";
     }
 }
 
 //=============================================================================
-// Shitty Text Fix
-//=============================================================================
-namespace TextFix {
-    // Replace UTF-8 chars that don't exist in SJIS with ones that do
-    std::string NormalizeUtf8(const std::string& utf8) {
-        std::string result;
-        result.reserve(utf8.size());
+// GYU Encoder
+//=============================================================================
+// Native port of GYU_Encode.py so PNG overrides can be converted in-process:
+// the engine's MT-keyed scramble, Retouch LZSS and the header/palette/alpha layout.
+namespace GyuEncoder {
+    constexpr uint32_t kHeaderSize = 36;
+    constexpr uint32_t kWindowSize = 4096;
+    constexpr uint32_t kWindowMask = kWindowSize - 1;
+    constexpr uint32_t kWindowStart = 0xFEE;
+    constexpr uint32_t kMinMatch = 3;
+    constexpr uint32_t kMaxMatch = 18;
+    constexpr int kMaxChainSteps = 256;
+
+    // Decoded source image, rows top-down and unpadded
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t bpp = 24;                // 24 = BGR triples, 8 = palette indices
+        std::vector<uint8_t> pixels;
+        std::vector<uint8_t> alpha;       // One byte per pixel, empty if opaque
+        std::vector<uint32_t> palette;    // 8bpp only, 0x00RRGGBB
+    };
 
-        for (size_t i = 0; i < utf8.size(); ) {
-            // Check for em-dash "?" (UTF-8: E2 80 94)
-            if (i + 2 < utf8.size() &&
-                (unsigned char)utf8[i] == 0xE2 &&
-                (unsigned char)utf8[i+1] == 0x80 &&
-                (unsigned char)utf8[i+2] == 0x94) {
-                // Replace with horizontal bar "―" (UTF-8: E2 80 95) - exists in SJIS
-                result += "\xE2\x80\x95";
-                i += 3;
-                continue;
-            }
+    // Ten keyed swaps over the compressed stream, in the order GYU_Encode.py applies them
+    static void Scramble(std::vector<uint8_t>& data, uint32_t key) {
+        if (data.empty()) return;
+        MersenneTwister rng(key);
+        uint32_t size = (uint32_t)data.size();
+        for (int i = 0; i < 10; i++) {
+            uint32_t a = rng.Rand(size);
+            uint32_t b = rng.Rand(size);
+            std::swap(data[a], data[b]);
+        }
+    }
+
+    // Retouch LZSS: 4 KB window starting at 0xFEE, 3-18 byte matches, flag bit 1 = literal.
+    // Hash chains stand in for the reference encoder's full window scan; any match the
+    // decoder can replay is valid, so the bytes differ but decode to the same image.
+    static std::vector<uint8_t> CompressLzss(const std::vector<uint8_t>& data) {
+        const size_t size = data.size();
+        std::vector<uint8_t> out;
+        out.reserve(size / 2 + 16);
+
+        std::vector<int32_t> head(1 << 16, -1);
+        std::vector<int32_t> prev(size, -1);
+        auto hashAt = [&](size_t pos) -> uint32_t {
+            uint32_t bytes = (uint32_t)data[pos] | ((uint32_t)data[pos + 1] << 8) | ((uint32_t)data[pos + 2] << 16);
+            return (bytes * 2654435761u) >> 16;
+        };
+        auto insert = [&](size_t pos) {
+            if (pos + kMinMatch > size) return;
+            uint32_t hash = hashAt(pos);
+            prev[pos] = head[hash];
+            head[hash] = (int32_t)pos;
+        };
 
-            // Check for en-dash "?" (UTF-8: E2 80 93)
-            if (i + 2 < utf8.size() &&
-                (unsigned char)utf8[i] == 0xE2 &&
-                (unsigned char)utf8[i+1] == 0x80 &&
-                (unsigned char)utf8[i+2] == 0x93) {
-                result += "\xE2\x80\x95";
-                i += 3;
-                continue;
+        size_t pos = 0;
+        uint32_t windowPos = kWindowStart;
+        size_t flagIndex = 0;
+        int flagBit = 8;
+
+        while (pos < size) {
+            if (flagBit == 8) {
+                flagIndex = out.size();
+                out.push_back(0);
+                flagBit = 0;
             }
 
-            // Check for curly quotes and replace with straight
-            if (i + 2 < utf8.size() &&
-                (unsigned char)utf8[i] == 0xE2 &&
-                (unsigned char)utf8[i+1] == 0x80) {
-                unsigned char c3 = (unsigned char)utf8[i+2];
-                if (c3 == 0x98 || c3 == 0x99) {  // ' or '
-                    result += "'";
-                    i += 3;
-                    continue;
-                }
-                if (c3 == 0x9C || c3 == 0x9D) {  // " or "
-                    result += "\"";
-                    i += 3;
-                    continue;
+            uint32_t bestLength = 0;
+            uint32_t bestBack = 0;
+            if (pos + kMinMatch <= size) {
+                uint32_t limit = (uint32_t)std::min<size_t>(kMaxMatch, size - pos);
+                int steps = kMaxChainSteps;
+                for (int32_t candidate = head[hashAt(pos)]; candidate >= 0 && steps-- > 0; candidate = prev[candidate]) {
+                    uint32_t back = (uint32_t)(pos - (size_t)candidate);
+                    if (back >= kWindowSize) break;
+
+                    // May run past pos - the decoder copies byte by byte, so overlaps replay
+                    uint32_t length = 0;
+                    while (length < limit && data[candidate + length] == data[pos + length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestBack = back;
+                        if (length == limit) break;
+                    }
                 }
             }
 
-            result += utf8[i];
-            i++;
+            if (bestLength >= kMinMatch) {
+                uint32_t offset = (windowPos - bestBack) & kWindowMask;
+                out.push_back((uint8_t)(offset & 0xFF));
+                out.push_back((uint8_t)(((offset >> 4) & 0xF0) | (bestLength - kMinMatch)));
+                for (uint32_t i = 0; i < bestLength; i++) insert(pos + i);
+                pos += bestLength;
+                windowPos = (windowPos + bestLength) & kWindowMask;
+            } else {
+                out[flagIndex] |= (uint8_t)(1 << flagBit);
+                out.push_back(data[pos]);
+                insert(pos);
+                pos++;
+                windowPos = (windowPos + 1) & kWindowMask;
+            }
+            flagBit++;
         }
 
-        return result;
+        return out;
     }
-}
-
-//=============================================================================
-// Translation Database
-//=============================================================================
-// Scene tracking globals
-namespace {
-    std::mutex g_sceneMutex;
-    std::string g_currentFile;
-    std::string g_currentLabel;
-}
 
-class TranslationDB {
-public:
-    bool Load(const char* tsvPath, const char* namesPath) {
-        std::lock_guard<std::mutex> lock(m_dataMutex);
+    // GYU rows are stored bottom-up and padded to 4 bytes
+    static std::vector<uint8_t> FlipRows(const std::vector<uint8_t>& rows, uint32_t rowBytes, uint32_t height) {
+        uint32_t stride = (rowBytes + 3) & ~3u;
+        std::vector<uint8_t> out((size_t)stride * height, 0);
+        for (uint32_t y = 0; y < height; y++) {
+            memcpy(&out[(size_t)(height - 1 - y) * stride], &rows[(size_t)y * rowBytes], rowBytes);
+        }
+        return out;
+    }
 
-        m_names.clear();
-        m_contextualNames.clear();
-        m_messages.clear();
-        m_originalNamesByIndex.clear();
-        m_labels.clear();
+    static void PutU16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back((uint8_t)value);
+        out.push_back((uint8_t)(value >> 8));
+    }
 
-        int globalCount = 0;
-        int contextualCount = 0;
-        int textCount = 0;
-        int choiceCount = 0;
-        int labelCount = 0;
+    static void PutU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (i * 8)));
+    }
 
-        // === STEP 1: Load global names from unique_names.tsv ===
-        if (namesPath) {
-            globalCount = LoadGlobalNames(namesPath);
-        }
+    static std::vector<uint8_t> Encode(const Image& image, uint32_t key) {
+        std::vector<uint8_t> data = CompressLzss(FlipRows(image.pixels, image.width * (image.bpp / 8), image.height));
+        Scramble(data, key);
 
-        // === STEP 2: Load translation.tsv (overrides global) ===
-        std::ifstream file(tsvPath, std::ios::binary | std::ios::ate);
-        if (!file) {
-            Log("[TL] Cannot open: %s\n", tsvPath);
-            return globalCount > 0;  // Still OK if we loaded names
+        std::vector<uint8_t> alpha;
+        if (!image.alpha.empty()) {
+            alpha = CompressLzss(FlipRows(image.alpha, image.width, image.height));
+            Scramble(alpha, key);
         }
 
-        size_t fileSize = (size_t)file.tellg();
-        file.seekg(0);
+        uint32_t paletteColors = (image.bpp == 8) ? 256 : 0;
 
-        std::string content(fileSize, 0);
-        file.read(&content[0], fileSize);
+        std::vector<uint8_t> out;
+        out.reserve(kHeaderSize + paletteColors * 4 + data.size() + alpha.size());
+        out.insert(out.end(), { 'G', 'Y', 'U', 0x1A });
+        PutU16(out, alpha.empty() ? 0x0000 : 0x0003);  // 0x0003 = 8-bit alpha plane
+        PutU16(out, 0x0000);                           // Standard LZSS
+        PutU32(out, key);
+        PutU32(out, image.bpp);
+        PutU32(out, image.width);
+        PutU32(out, image.height);
+        PutU32(out, (uint32_t)data.size());
+        PutU32(out, (uint32_t)alpha.size());
+        PutU32(out, paletteColors);
 
-        Encoding::Type encoding = Encoding::Detect(content.c_str(), content.size());
-        std::string utf8Content = Encoding::ToUtf8(content, encoding);
+        for (uint32_t i = 0; i < paletteColors; i++) {
+            uint32_t color = (i < image.palette.size()) ? image.palette[i] : 0;
+            out.insert(out.end(), { (uint8_t)color, (uint8_t)(color >> 8), (uint8_t)(color >> 16), 0 });
+        }
 
-        // First pass: collect entries by index
-        std::map<std::pair<std::string, int>, std::string> namesByIndex;
-        std::map<std::pair<std::string, int>, std::string> textsByIndex;
+        out.insert(out.end(), data.begin(), data.end());
+        out.insert(out.end(), alpha.begin(), alpha.end());
+        return out;
+    }
 
-        std::istringstream iss(utf8Content);
-        std::string line;
+    // Scramble key of an existing GYU, so a replacement keeps the original's
+    static bool ReadKey(const char* gyuPath, uint32_t& key) {
+        FILE* f = nullptr;
+        if (fopen_s(&f, gyuPath, "rb") != 0 || !f) return false;
 
-        while (std::getline(iss, line)) {
-            if (!line.empty() && line.back() == '\r') line.pop_back();
-            if (line.empty() || line[0] == '#') continue;
+        uint8_t header[kHeaderSize];
+        bool valid = fread(header, 1, sizeof(header), f) == sizeof(header) && memcmp(header, "GYU\x1a", 4) == 0;
+        fclose(f);
 
-            std::vector<std::string> parts;
-            size_t start = 0, end;
-            while ((end = line.find('\t', start)) != std::string::npos) {
-                parts.push_back(line.substr(start, end - start));
-                start = end + 1;
-            }
-            parts.push_back(line.substr(start));
-
-            if (parts.size() < 5 || parts[4].empty()) continue;
-
-            std::string fileId = parts[0];
-            int index = std::atoi(parts[1].c_str());
-            std::string type = parts[2];
-            std::string original = parts[3];
-            std::string translated = parts[4];
-
-            UnescapeString(original);
-            UnescapeString(translated);
-
-            auto key = std::make_pair(fileId, index);
-
-            if (type == "NAME") {
-                namesByIndex[key] = translated;
-                m_originalNamesByIndex[key] = original;
-            } else if (type == "TEXT" || type == "MSG") {
-                textsByIndex[key] = original;
-                m_messages[original] = translated;
-                m_messageToFile[original] = fileId;
-                m_messageToIndex[original] = index;
-                textCount++;
-            } else if (type == "LABEL") {
-                m_labels[original] = translated;
-                m_labelsByFileIndex[std::make_pair(fileId, index)] =
-                    translated.empty() ? original : translated;
-                labelCount++;
-            } else if (type.rfind("CHOICE_", 0) == 0) {
-                m_messages[original] = translated;
-                choiceCount++;
-            }
-        }
+        if (valid) memcpy(&key, header + 8, sizeof(key));
+        return valid;
+    }
 
-        // Second pass: build contextual names (these OVERRIDE global)
-        for (const auto& [key, translatedName] : namesByIndex) {
-            std::string originalName = m_originalNamesByIndex[key];
+    template <typename T>
+    struct ComRef {
+        T* ptr = nullptr;
+        ~ComRef() { if (ptr) ptr->Release(); }
+        T* operator->() const { return ptr; }
+    };
 
-            auto textIt = textsByIndex.find(key);
-            if (textIt != textsByIndex.end()) {
-                // Contextual: "name|message" -> translation
-                std::string contextKey = originalName + "|" + textIt->second;
-                m_contextualNames[contextKey] = translatedName;
-                contextualCount++;
-            } else {
-                // No text at same index - override global
-                m_names[originalName] = translatedName;
-                // Don't increment globalCount - it was loaded from unique_names
+    // Paletted PNGs without transparency stay 8bpp; everything else becomes BGR
+    // plus an alpha plane when any pixel is not fully opaque
+    static bool DecodePng(IWICImagingFactory* factory, const std::string& bytes, Image& image) {
+        ComRef<IWICStream> stream;
+        ComRef<IWICBitmapDecoder> decoder;
+        ComRef<IWICBitmapFrameDecode> frame;
+        if (FAILED(factory->CreateStream(&stream.ptr))) return false;
+        if (FAILED(stream->InitializeFromMemory((BYTE*)bytes.data(), (DWORD)bytes.size()))) return false;
+        if (FAILED(factory->CreateDecoderFromStream(stream.ptr, nullptr, WICDecodeMetadataCacheOnDemand, &decoder.ptr))) return false;
+        if (FAILED(decoder->GetFrame(0, &frame.ptr))) return false;
+
+        UINT width = 0, height = 0;
+        if (FAILED(frame->GetSize(&width, &height)) || width == 0 || height == 0) return false;
+        image.width = width;
+        image.height = height;
+
+        WICPixelFormatGUID format;
+        if (SUCCEEDED(frame->GetPixelFormat(&format)) && IsEqualGUID(format, GUID_WICPixelFormat8bppIndexed)) {
+            ComRef<IWICPalette> palette;
+            WICColor colors[256];
+            UINT colorCount = 0;
+            BOOL hasAlpha = TRUE;
+            if (SUCCEEDED(factory->CreatePalette(&palette.ptr)) &&
+                SUCCEEDED(frame->CopyPalette(palette.ptr)) &&
+                SUCCEEDED(palette->HasAlpha(&hasAlpha)) && !hasAlpha &&
+                SUCCEEDED(palette->GetColors(256, colors, &colorCount))) {
+                image.bpp = 8;
+                image.palette.assign(colors, colors + colorCount);
+                image.pixels.resize((size_t)width * height);
+                return SUCCEEDED(frame->CopyPixels(nullptr, width, (UINT)image.pixels.size(), image.pixels.data()));
             }
         }
 
-        const char* encodingName = "Unknown";
-        switch (encoding) {
-            case Encoding::Type::UTF8_BOM: encodingName = "UTF-8 (BOM)"; break;
-            case Encoding::Type::UTF8: encodingName = "UTF-8"; break;
-            case Encoding::Type::ShiftJIS: encodingName = "Shift-JIS"; break;
-            default: break;
-        }
+        ComRef<IWICBitmapSource> bgra;
+        if (FAILED(WICConvertBitmapSource(GUID_WICPixelFormat32bppBGRA, frame.ptr, &bgra.ptr))) return false;
 
-        Log("[TL] Loaded (%s):\n", encodingName);
-        Log("[TL]   %d global names (from %s)\n", globalCount, namesPath ? namesPath : "none");
-        Log("[TL]   %d contextual names (from %s)\n", contextualCount, tsvPath);
-        Log("[TL]   %d texts\n", textCount);
-        Log("[TL]   %d choices\n", choiceCount);
-        Log("[TL]   %d labels\n", labelCount);
+        size_t pixelCount = (size_t)width * height;
+        std::vector<uint8_t> pixels(pixelCount * 4);
+        if (FAILED(bgra->CopyPixels(nullptr, width * 4, (UINT)pixels.size(), pixels.data()))) return false;
 
+        image.bpp = 24;
+        image.pixels.resize(pixelCount * 3);
+        image.alpha.resize(pixelCount);
+        bool opaque = true;
+        for (size_t i = 0; i < pixelCount; i++) {
+            image.pixels[i * 3 + 0] = pixels[i * 4 + 0];
+            image.pixels[i * 3 + 1] = pixels[i * 4 + 1];
+            image.pixels[i * 3 + 2] = pixels[i * 4 + 2];
+            image.alpha[i] = pixels[i * 4 + 3];
+            opaque = opaque && pixels[i * 4 + 3] == 0xFF;
+        }
+        if (opaque) image.alpha.clear();
         return true;
     }
+}
+
+//=============================================================================
+// Asset Redirection
+//=============================================================================
+namespace AssetRedirect {
 
-    void Reload() {
-        Log("[TL] Reloading...\n");
-        Load(Config::translationFile, Config::namesFile);
+    static std::string GetFileName(const std::string& path) {
+        size_t pos = path.find_last_of("\\/");
+        return (pos != std::string::npos) ? path.substr(pos + 1) : path;
     }
 
-        void FindInDB(const std::string& searchText) {
-        std::lock_guard<std::mutex> lock(m_dataMutex);
+    static std::string GetRelativePath(const std::string& fullPath) {
+        // Look for "res\" in the path
+        size_t resPos = fullPath.find("res\\");
+        if (resPos != std::string::npos) {
+            return fullPath.substr(resPos + 4);
+        }
+        return GetFileName(fullPath);
+    }
 
-        int found = 0;
-        Log("\n[SEARCH] Looking for: %s\n", searchText.c_str());
+    // Everything under tlAssetsPath, keyed by lowercase path relative to it.
+    // Built by a directory scan so redirect lookups never touch the disk.
+    using Manifest = std::unordered_map<std::string, std::string>;
 
-        for (const auto& [key, val] : m_messages) {
-            if (key.find(searchText) != std::string::npos ||
-                val.find(searchText) != std::string::npos) {
-                Log("  [%s] -> [%s]\n",
-                    key.substr(0, 40).c_str(),
-                    val.substr(0, 40).c_str());
-                found++;
-                if (found >= Constants::kMaxSearchResults) {
-                    Log("  ... (showing first %d)\n", Constants::kMaxSearchResults);
-                    break;
-                }
-            }
-        }
+    static std::shared_ptr<const Manifest> g_manifest = std::make_shared<Manifest>();
 
-        if (found == 0) {
-            Log("  No matches found.\n");
+    static std::string ToKey(std::string path) {
+        for (char& c : path) {
+            if (c == '/') c = '\\';
+            else if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
         }
-        Log("\n");
+        return path;
     }
 
-    // Context-aware name lookup
-    const std::string* FindNameTranslation(const char* sjisName, const char* sjisMessage) {
-        if (!sjisName || !*sjisName) return nullptr;
-
-        std::string utf8Name = Encoding::SjisToUtf8(sjisName);
-        if (utf8Name.empty()) return nullptr;
+    static void ScanDirectory(const std::string& root, const std::string& relative, Manifest& out) {
+        WIN32_FIND_DATAA data;
+        HANDLE find = FindFirstFileA((root + relative + "*").c_str(), &data);
+        if (find == INVALID_HANDLE_VALUE) return;
 
-        std::lock_guard<std::mutex> lock(m_dataMutex);
+        do {
+            if (strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0) continue;
 
-        // Try contextual lookup first (name + message)
-        if (sjisMessage && *sjisMessage) {
-            std::string utf8Msg = Encoding::SjisToUtf8(sjisMessage);
-            std::string contextKey = utf8Name + "|" + utf8Msg;
-
-            auto it = m_contextualNames.find(contextKey);
-            if (it != m_contextualNames.end()) {
-                return &it->second;
+            std::string path = relative + data.cFileName;
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                ScanDirectory(root, path + "\\", out);
+            } else {
+                out.emplace(ToKey(path), root + path);
             }
-        }
-
-        // Fall back to global name lookup
-        auto it = m_names.find(utf8Name);
-        if (it != m_names.end()) {
-            return &it->second;
-        }
+        } while (FindNextFileA(find, &data));
 
-        LogMissing(utf8Name.c_str(), "NAME");
-        return nullptr;
+        FindClose(find);
     }
 
-    const std::string* FindMessageTranslation(const char* sjisMessage) {
-        if (!sjisMessage || !*sjisMessage) return nullptr;
+    // Rebuild the manifest and swap it in; lookups in flight keep the old one
+    static void Rescan() {
+        auto manifest = std::make_shared<Manifest>();
+        ScanDirectory(Config::tlAssetsPath, "", *manifest);
+        std::atomic_store(&g_manifest, std::shared_ptr<const Manifest>(std::move(manifest)));
+        Log("[ASSET] Indexed %d replacement files\n", (int)std::atomic_load(&g_manifest)->size());
+    }
 
-        std::string utf8Key = Encoding::SjisToUtf8(sjisMessage);
-        if (utf8Key.empty()) return nullptr;
+    static std::string FindReplacement(const std::string& originalPath) {
+        if (!Config::enableAssetRedirect) return "";
 
-        std::lock_guard<std::mutex> lock(m_dataMutex);
+        std::shared_ptr<const Manifest> manifest = std::atomic_load(&g_manifest);
+        if (manifest->empty()) return "";
 
-        auto it = m_messages.find(utf8Key);
-        if (it != m_messages.end()) {
-            m_hitCount++;
-            {
-                std::lock_guard<std::mutex> slock(m_statsMutex);
-                m_usedKeys.insert(utf8Key);
-            }
+        auto find = [&](const std::string& key) -> const std::string* {
+            auto it = manifest->find(key);
+            return (it != manifest->end()) ? &it->second : nullptr;
+        };
 
-            // Track current scene from matched message
-            auto fileIt = m_messageToFile.find(utf8Key);
-            auto indexIt = m_messageToIndex.find(utf8Key);
-            if (fileIt != m_messageToFile.end() && indexIt != m_messageToIndex.end()) {
-                std::string label = GetNearestLabel(fileIt->second, indexIt->second);
-
-                std::lock_guard<std::mutex> sceneLock(g_sceneMutex);
-                if (g_currentFile != fileIt->second || g_currentLabel != label) {
-                    g_currentFile = fileIt->second;
-                    g_currentLabel = label;
-                    // Only log on scene change
-                    if (!label.empty()) {
-                        Log("[SCENE] %s | %s\n", g_currentFile.c_str(), g_currentLabel.c_str());
-                    }
-                }
-            }
+        std::string relativePath = ToKey(GetRelativePath(originalPath));
 
-            // Update Discord Presence with current label
-            std::string display = g_currentLabel.c_str();
-            size_t bracket = display.rfind(" [");
-            if (bracket != std::string::npos) display.erase(bracket);
-            UpdateChapterPresence(display);
+        // Try 1: Exact path (tl/assets/g/ev/xxx.gyu)
+        if (const std::string* path = find(relativePath)) return *path;
 
-            return &it->second;
+        // Try 2: PNG version of exact path
+        size_t extPos = relativePath.rfind(".gyu");
+        if (extPos != std::string::npos) {
+            if (const std::string* path = find(relativePath.substr(0, extPos) + ".png")) return *path;
         }
 
-        m_missCount++;
-        {
-            std::lock_guard<std::mutex> slock(m_statsMutex);
-            m_missedTexts.insert(utf8Key);
+        // Try 3: Flat structure (tl/assets/xxx.gyu)
+        std::string filename = ToKey(GetFileName(originalPath));
+        if (filename != relativePath) {
+            if (const std::string* path = find(filename)) return *path;
+
+            // Try 4: Flat PNG (tl/assets/xxx.png)
+            extPos = filename.rfind(".gyu");
+            if (extPos != std::string::npos) {
+                if (const std::string* path = find(filename.substr(0, extPos) + ".png")) return *path;
+            }
         }
 
-        LogMissing(utf8Key.c_str(), "TEXT");
-        return nullptr;
+        return "";
     }
 
-    // Simple lookup for UI elements (dialogs, buttons) - no logging or tracking
-    const std::string* FindUITranslation(const char* sjisText) {
-        if (!sjisText || !*sjisText) return nullptr;
+    //-------------------------------------------------------------------------
+    // PNG overrides - transcoded once into AssetCachePath as <content hash>.gyu
+    //-------------------------------------------------------------------------
+    struct CachedPng {
+        uint64_t size = 0;
+        uint64_t writeTime = 0;
+        std::string gyuPath;   // Set by the worker once it has hashed this version
+        bool ready = false;    // gyuPath exists and can be served
+    };
+
+    struct TranscodeJob {
+        std::string pngPath;
+        std::string originalPath;  // The game's .gyu - supplies the scramble key
+        uint64_t size;             // The version of the PNG that was queued
+        uint64_t writeTime;
 
-        std::string utf8Key = Encoding::SjisToUtf8(sjisText);
-        if (utf8Key.empty()) return nullptr;
+        // Filled in by the worker
+        std::string gyuPath;
+        std::string bytes;
+        uint64_t hash = 0;
+    };
 
-        std::lock_guard<std::mutex> lock(m_dataMutex);
-        auto it = m_messages.find(utf8Key);
-        return (it != m_messages.end()) ? &it->second : nullptr;
-    }
+    static std::unordered_map<std::string, CachedPng> g_pngCache;  // Keyed by PNG path
+    static std::deque<TranscodeJob> g_transcodeQueue;
+    static std::mutex g_transcodeMutex;
+    static HANDLE g_transcodeEvent = nullptr;
+    static HANDLE g_transcodeThread = nullptr;
+    static std::atomic<bool> g_transcodeStopping{false};
 
-    // Label
-    const std::string* FindLabelTranslation(const char* sjisLabel) {
-        if (!sjisLabel || !*sjisLabel) return nullptr;
+    static bool ReadWholeFile(const std::string& path, std::string& content) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
 
-        std::string utf8Key = Encoding::SjisToUtf8(sjisLabel);
-        if (utf8Key.empty()) return nullptr;
+        size_t fileSize = (size_t)file.tellg();
+        file.seekg(0);
 
-        std::lock_guard<std::mutex> lock(m_dataMutex);
+        content.assign(fileSize, 0);
+        file.read(&content[0], fileSize);
+        return (bool)file;
+    }
+
+    // Path of the transcoded GYU to open instead of pngPath, or "" to let the
+    // game load its own file while the worker reads, hashes and transcodes it.
+    // Runs on the game's loading path, so it is one stat and a map lookup.
+    static std::string ResolvePng(const char* originalPath, const std::string& pngPath) {
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+        if (!GetFileAttributesExA(pngPath.c_str(), GetFileExInfoStandard, &attributes)) return "";
+        uint64_t size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+        uint64_t writeTime = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) |
+            attributes.ftLastWriteTime.dwLowDateTime;
+
+        std::lock_guard<std::mutex> lock(g_transcodeMutex);
+        CachedPng& entry = g_pngCache[pngPath];
+        if (entry.size == size && entry.writeTime == writeTime) {
+            return entry.ready ? entry.gyuPath : "";
+        }
+        if (!g_transcodeThread) return "";
+
+        // Pending until the worker has looked at this version
+        entry = { size, writeTime, "", false };
+        g_transcodeQueue.push_back({ pngPath, originalPath, size, writeTime });
+        SetEvent(g_transcodeEvent);
+        Log(LogCategory::Asset, "[ASSET] Queued %s\n", pngPath.c_str());
+        return "";
+    }
 
-        // Try exact match first
-        auto it = m_labels.find(utf8Key);
-        if (it != m_labels.end()) {
-            return &it->second;
+    static bool Transcode(IWICImagingFactory* factory, const TranscodeJob& job) {
+        GyuEncoder::Image image;
+        if (!factory || !GyuEncoder::DecodePng(factory, job.bytes, image)) {
+            Log(LogCategory::Asset, "[ASSET] Failed to decode %s\n", job.pngPath.c_str());
+            return false;
         }
 
-        // Save files don't include [X] suffix, but TSV does
-        // Try appending " [1]", " [2]", etc.
-        for (int i = 1; i <= Constants::kMaxLabelSuffixSearch; i++) {
-            std::string withSuffix = utf8Key + " [" + std::to_string(i) + "]";
-            it = m_labels.find(withSuffix);
-            if (it != m_labels.end()) {
-                return &it->second;
-            }
+        // Same range GYU_Encode.py draws a fresh key from
+        uint32_t key = 0;
+        if (!GyuEncoder::ReadKey(job.originalPath.c_str(), key)) {
+            key = (uint32_t)job.hash | 0x10000000;
         }
 
-        LogMissing(utf8Key.c_str(), "LABEL");
-        return nullptr;
-    }
+        std::vector<uint8_t> gyu = GyuEncoder::Encode(image, key);
 
-    std::string GetNearestLabel(const std::string& file, int index) {
-        // Find highest label index <= message index
-        std::string bestLabel;
-        int bestIndex = -1;
+        // Write beside the target and rename, so a half-written file is never served
+        std::string tempPath = job.gyuPath + ".tmp";
+        FILE* f = nullptr;
+        if (fopen_s(&f, tempPath.c_str(), "wb") != 0 || !f) {
+            Log(LogCategory::Asset, "[ASSET] Failed to write %s\n", tempPath.c_str());
+            return false;
+        }
+        bool written = fwrite(gyu.data(), 1, gyu.size(), f) == gyu.size();
+        fclose(f);
 
-        for (const auto& [key, label] : m_labelsByFileIndex) {
-            if (key.first == file && key.second <= index && key.second > bestIndex) {
-                bestIndex = key.second;
-                bestLabel = label;
-            }
+        if (!written || !MoveFileExA(tempPath.c_str(), job.gyuPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileA(tempPath.c_str());
+            Log(LogCategory::Asset, "[ASSET] Failed to write %s\n", job.gyuPath.c_str());
+            return false;
         }
 
-        return bestLabel;
+        Log(LogCategory::Asset, "[ASSET] Transcoded %s -> %s (%ux%u, %u bpp%s)\n",
+            job.pngPath.c_str(), job.gyuPath.c_str(), image.width, image.height, image.bpp,
+            image.alpha.empty() ? "" : " + alpha");
+        return true;
     }
 
-    std::atomic<int> m_hitCount{0};
-    std::atomic<int> m_missCount{0};
-    std::unordered_set<std::string> m_usedKeys;  // Track which translations were used
-    std::mutex m_statsMutex;
+    // Read and hash the PNG, then reuse its cached GYU or transcode a new one
+    static bool Prepare(IWICImagingFactory* factory, TranscodeJob& job) {
+        if (!ReadWholeFile(job.pngPath, job.bytes)) {
+            Log(LogCategory::Asset, "[ASSET] Failed to read %s\n", job.pngPath.c_str());
+            return false;
+        }
+        job.hash = HashBytes(kHashSeed, job.bytes);  // Of the PNG itself, so an edit always lands in a fresh cache file
+
+        char gyuPath[MAX_PATH];
+        sprintf_s(gyuPath, "%s%016llx.gyu", Config::assetCachePath, (unsigned long long)job.hash);
+        job.gyuPath = gyuPath;
 
-    void PrintStats() {
-        std::lock_guard<std::mutex> lock(m_dataMutex);
-        std::lock_guard<std::mutex> slock(m_statsMutex);
+        if (GetFileAttributesA(gyuPath) != INVALID_FILE_ATTRIBUTES) return true;
+        return Transcode(factory, job);
+    }
 
-        Log("\n========== Translation Stats ==========\n");
-        Log("  Loaded: %d messages, %d labels, %d names\n",
-            (int)m_messages.size(), (int)m_labels.size(), (int)m_names.size());
-        Log("  Hits: %d | Misses: %d\n", m_hitCount.load(), m_missCount.load());
-        Log("  Unique texts matched: %d\n", (int)m_usedKeys.size());
+    static DWORD WINAPI TranscodeThreadProc(LPVOID) {
+        HRESULT com = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        IWICImagingFactory* factory = nullptr;
+        if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory)))) {
+            factory = nullptr;
+            Log("[ASSET] WIC unavailable - PNG overrides will not be transcoded\n");
+        }
 
-        // Show missed texts (game sent but not in TSV)
-        if (!m_missedTexts.empty()) {
-            Log("\n--- Missed (game sent, not in TSV): ---\n");
-            int count = 0;
-            for (const auto& text : m_missedTexts) {
-                if (count++ < Constants::kMaxMissedTextsToShow) {
-                    Log("  %s\n", text.substr(0, 70).c_str());
+        while (!g_transcodeStopping.load(std::memory_order_acquire)) {
+            TranscodeJob job;
+            {
+                std::unique_lock<std::mutex> lock(g_transcodeMutex);
+                if (g_transcodeQueue.empty()) {
+                    lock.unlock();
+                    WaitForSingleObject(g_transcodeEvent, INFINITE);
+                    continue;
                 }
+                job = std::move(g_transcodeQueue.front());
+                g_transcodeQueue.pop_front();
             }
-            if (m_missedTexts.size() > Constants::kMaxMissedTextsToShow) {
-                Log("  ... +%d more\n", (int)m_missedTexts.size() - Constants::kMaxMissedTextsToShow);
+
+            bool ok = Prepare(factory, job);
+
+            // An edit since the job was queued has queued another one
+            std::lock_guard<std::mutex> lock(g_transcodeMutex);
+            auto it = g_pngCache.find(job.pngPath);
+            if (it != g_pngCache.end() && it->second.size == job.size && it->second.writeTime == job.writeTime) {
+                it->second.gyuPath = job.gyuPath;
+                it->second.ready = ok;
             }
-        } else {
-            Log("\n  No missed texts! Everything translated.\n");
         }
 
-        Log("=========================================\n\n");
+        if (factory) factory->Release();
+        if (SUCCEEDED(com)) CoUninitialize();
+        return 0;
+    }
+
+    static void StartTranscoder() {
+        CreateDirectoryA(Config::assetCachePath, nullptr);
+        g_transcodeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        g_transcodeThread = CreateThread(nullptr, 0, TranscodeThreadProc, nullptr, 0, nullptr);
     }
 
-private:
-    void UnescapeString(std::string& s) {
-        size_t pos = 0;
-        while ((pos = s.find("\\n", pos)) != std::string::npos) {
-            s.replace(pos, 2, "\n");
-            pos += 1;
-        }
-        pos = 0;
-        while ((pos = s.find("\\t", pos)) != std::string::npos) {
-            s.replace(pos, 2, "\t");
-            pos += 1;
-        }
+    static void StopTranscoder() {
+        if (!g_transcodeThread) return;
+        g_transcodeStopping.store(true, std::memory_order_release);
+        SetEvent(g_transcodeEvent);
+        WaitForSingleObject(g_transcodeThread, 1000);
+        CloseHandle(g_transcodeThread);
+        g_transcodeThread = nullptr;
     }
+}
 
-    void LogMissing(const char* utf8Text, const char* type) {
-        if (!Config::dumpUntranslated) return;
+//=============================================================================
+// Translation Database
+//=============================================================================
+static TranslationDB g_translationDB;
 
-        std::lock_guard<std::mutex> lock(m_logMutex);
+//=============================================================================
+// Startup Readiness
+//=============================================================================
+// Translations and the char table load on the deferred init thread. A hook
+// that gets a line first waits for them instead of showing it untranslated -
+// for at most kTranslationsWaitMs, after which text shows untranslated until
+// the load lands. After that this is one acquire load.
+static std::atomic<bool> g_translationsReady{false};
+static HANDLE g_translationsReadyEvent = nullptr;  // Manual reset, created in DllMain
 
-        std::string key(utf8Text);
-        if (m_logged.count(key)) return;
-        m_logged.insert(key);
+static void WaitForTranslations() {
+    if (g_translationsReady.load(std::memory_order_acquire)) return;
 
-        std::ofstream file(Config::untranslatedLog, std::ios::app | std::ios::binary);
-        if (file) {
-            std::string escaped = key;
-            size_t pos = 0;
-            while ((pos = escaped.find('\n', pos)) != std::string::npos) {
-                escaped.replace(pos, 1, "\\n");
-                pos += 2;
-            }
-            file << "RUNTIME\t0\t" << type << "\t" << escaped << "\t\r\n";
-        }
+    static std::atomic<bool> s_logged{false};
+    if (!s_logged.exchange(true)) {
+        Log("[INIT] Text arrived before translations finished loading - waiting\n");
+    }
+    if (WaitForSingleObject(g_translationsReadyEvent, Constants::kTranslationsWaitMs) != WAIT_OBJECT_0) {
+        Log("[INIT] Translations still not loaded after %u ms - showing original text meanwhile\n",
+            Constants::kTranslationsWaitMs);
+        g_translationsReady.store(true, std::memory_order_release);  // Don't stall the next line too
     }
+}
 
-    int LoadGlobalNames(const char* namesPath) {
-        std::ifstream file(namesPath, std::ios::binary | std::ios::ate);
-        if (!file) {
-            Log("[TL] No global names file: %s\n", namesPath);
-            return 0;
-        }
+static void SignalTranslationsReady() {
+    g_translationsReady.store(true, std::memory_order_release);
+    SetEvent(g_translationsReadyEvent);
+}
 
-        size_t fileSize = (size_t)file.tellg();
-        file.seekg(0);
+//=============================================================================
+// Character ID → Original Name Lookup (from char_table.tsv)
+//=============================================================================
+struct CharName {
+    std::string utf8;  // For logging
+    std::string sjis;  // Game encoding, used as the name lookup key
+};
+static std::unordered_map<int, CharName> g_charIdToName;  // ID → original JP name
 
-        std::string content(fileSize, 0);
-        file.read(&content[0], fileSize);
+static void LoadCharIdTable(const char* path) {
+    TextFile file;
+    if (!file.Open(path)) {
+        Log("[TL] No char_table.tsv found\n");
+        return;
+    }
 
-        Encoding::Type encoding = Encoding::Detect(content.c_str(), content.size());
-        std::string utf8Content = Encoding::ToUtf8(content, encoding);
+    int count = 0;
+    for (const Tsv::Row& row : Tsv::ReadRows(file.Text())) {
+        if (row.line.substr(0, 2) == "ID") continue;  // Skip header
+        if (row.fieldCount < 2) continue;
 
-        int count = 0;
-        std::istringstream iss(utf8Content);
-        std::string line;
-
-        while (std::getline(iss, line)) {
-            if (!line.empty() && line.back() == '\r') line.pop_back();
-            if (line.empty() || line[0] == '#') continue;
-
-            // Skip header line
-            if (line.find("ORIGINAL") == 0) continue;
-
-            // Split by tab
-            size_t tabPos = line.find('\t');
-            if (tabPos == std::string::npos) continue;
-
-            std::string original = line.substr(0, tabPos);
-            std::string translated = line.substr(tabPos + 1);
-
-            // Remove trailing tab/count if present
-            size_t tabPos2 = translated.find('\t');
-            if (tabPos2 != std::string::npos) {
-                translated = translated.substr(0, tabPos2);
-            }
-
-            // Trim whitespace
-            while (!translated.empty() && (translated.back() == ' ' || translated.back() == '\t')) {
-                translated.pop_back();
-            }
-
-            // Skip if empty (user hasn't filled it in yet)
-            if (original.empty() || translated.empty()) continue;
-
-            UnescapeString(original);
-            UnescapeString(translated);
-
-            m_names[original] = translated;
-            count++;
-        }
-
-        return count;
-    }
-
-    // Storage
-    std::unordered_map<std::string, std::string> m_contextualNames;  // "name|message" -> translated_name
-    std::unordered_map<std::string, std::string> m_names;            // name -> translated (fallback)
-    std::unordered_map<std::string, std::string> m_messages;         // message -> translated
-    std::unordered_map<std::string, std::string> m_labels;           // label -> translated
-    std::unordered_map<std::string, std::string> m_messageToFile;    // message -> file
-    std::unordered_map<std::string, int> m_messageToIndex;           // message -> index
-    std::map<std::pair<std::string, int>, std::string> m_labelsByFileIndex;  // (file,index) -> label
-    std::map<std::pair<std::string, int>, std::string> m_originalNamesByIndex;
-    std::unordered_set<std::string> m_logged;
-    std::unordered_set<std::string> m_missedTexts;
-    std::mutex m_dataMutex;
-    std::mutex m_logMutex;
-};
-
-
-static TranslationDB g_translationDB;
-
-//=============================================================================
-// String Pool
-//=============================================================================
-class StringPool {
-public:
-    const char* Store(const std::string& str) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto it = m_pool.find(str);
-        if (it != m_pool.end()) return it->second.c_str();
-        m_pool[str] = str;
-        return m_pool[str].c_str();
-    }
-
-    void Clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_pool.clear();
-    }
-
-private:
-    std::unordered_map<std::string, std::string> m_pool;
-    std::mutex m_mutex;
-};
-
-static StringPool g_stringPool;
-
-//=============================================================================
-// Word Wrapping
-//=============================================================================
-namespace WordWrap {
-    bool IsSjisLead(unsigned char c) {
-        return (c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC);
-    }
-
-    std::string Wrap(const std::string& text, int maxWidth) {
-        if (text.empty() || maxWidth <= 0) return text;
-
-        std::string result;
-        result.reserve(text.size() + 64);
-
-        int lineLen = 0;
-        size_t lineStart = 0;
-        size_t lastSpace = std::string::npos;
-
-        for (size_t i = 0; i < text.size(); ) {
-            unsigned char c = (unsigned char)text[i];
-
-            // Existing newline - reset
-            if (c == '\n') {
-                result += c;
-                lineLen = 0;
-                lineStart = result.size();
-                lastSpace = std::string::npos;
-                i++;
-                continue;
-            }
-
-            // SJIS double-byte (Japanese) - don't count for word wrap
-            if (IsSjisLead(c) && i + 1 < text.size()) {
-                result += text[i];
-                result += text[i + 1];
-                lineLen += 2;
-                i += 2;
-                continue;
-            }
-
-            // Remember last space position for word wrap
-            if (c == ' ') {
-                lastSpace = result.size();
-            }
-
-            result += c;
-            lineLen++;
-
-            // Need to wrap?
-            if (lineLen >= maxWidth) {
-                if (lastSpace != std::string::npos && lastSpace > lineStart) {
-                    // Replace space with newline
-                    result[lastSpace] = '\n';
-                    lineLen = (int)(result.size() - lastSpace - 1);
-                    lineStart = lastSpace + 1;
-                    lastSpace = std::string::npos;
-                }
-                // else: no good break point, let it overflow (game will handle)
-            }
-
-            i++;
-        }
-
-        return result;
-    }
-}
-
-//=============================================================================
-// Hot Reload Thread
-//=============================================================================
-static std::atomic<bool> g_running{true};
-static HANDLE g_hotkeyThread = nullptr;
-
-static DWORD WINAPI HotkeyThreadProc(LPVOID) {
-    while (g_running) {
-        // Reload translations
-        if (GetAsyncKeyState(Config::reloadHotkey) & 0x8000) {
-            while (GetAsyncKeyState(Config::reloadHotkey) & 0x8000) Sleep(10);
-            g_stringPool.Clear();
-            g_translationDB.Reload();
-            MessageBeep(MB_OK);
-        }
-
-        // Print stats
-        if (GetAsyncKeyState(Config::statsHotkey) & 0x8000) {
-            while (GetAsyncKeyState(Config::statsHotkey) & 0x8000) Sleep(10);
-            g_translationDB.PrintStats();
-            MessageBeep(MB_OK);
-        }
-
-        // Toggle logging
-        if (GetAsyncKeyState(Config::logToggleHotkey) & 0x8000) {
-            while (GetAsyncKeyState(Config::logToggleHotkey) & 0x8000) Sleep(10);
-            Config::enableTextLogging = !Config::enableTextLogging;
-            Log("[*] Text logging: %s\n", Config::enableTextLogging ? "ON" : "OFF");
-            MessageBeep(MB_OK);
-        }
-
-        Sleep(Constants::kHotkeyPollIntervalMs);
-    }
-    return 0;
-}
-
-//=============================================================================
-// Character ID → Original Name Lookup (from char_table.tsv)
-//=============================================================================
-static std::unordered_map<int, std::string> g_charIdToName;  // ID → original JP name
-
-static void LoadCharIdTable(const char* path) {
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file) {
-        Log("[TL] No char_table.tsv found\n");
-        return;
-    }
-
-    size_t size = (size_t)file.tellg();
-    file.seekg(0);
-    std::string content(size, 0);
-    file.read(&content[0], size);
-
-    Encoding::Type enc = Encoding::Detect(content.c_str(), size);
-    std::string utf8 = Encoding::ToUtf8(content, enc);
-
-    std::istringstream iss(utf8);
-    std::string line;
-    int count = 0;
-
-    while (std::getline(iss, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        if (line.back() == '\r') line.pop_back();
-        if (line.find("ID") == 0) continue;  // Skip header
-
-        size_t tab = line.find('\t');
-        if (tab == std::string::npos) continue;
-
-        int id = std::atoi(line.substr(0, tab).c_str());
-        std::string name = line.substr(tab + 1);
+        // The name is the rest of the line, tabs included
+        int id = Tsv::ToInt(row.fields[0]);
+        std::string name(row.line.substr(row.fields[1].data() - row.line.data()));
 
         if (id > 0 && !name.empty()) {
-            g_charIdToName[id] = name;
+            g_charIdToName[id] = { name, Encoding::Utf8ToSjis(name.c_str()) };
             count++;
         }
     }
@@ -1272,80 +1311,79 @@ static void __fastcall AdvCharSay_Hook(
     int voiceId, const char* name, const char* message,
     bool flag, int flags, int p1, int p2, int p3, void* printParam)
 {
+    Perf::Scope perf(Perf::kAdvCharSay);
     const char* finalName = name;
     const char* finalMsg = message;
 
-    // If name is NULL, look up by CharID
-    if ((!name || !*name) && pThis) {
-        int charId = *((int*)((uintptr_t)pThis + 4));
-
-        if (charId > 0) {
-            // Step 1: CharID → original name
-            auto it = g_charIdToName.find(charId);
-            if (it != g_charIdToName.end()) {
-                const std::string& origName = it->second;
-
-                // Step 2: original name → translation (via unique_names.tsv)
-                std::string sjisName = Encoding::Utf8ToSjis(origName.c_str());
-                const std::string* tlUtf8 = g_translationDB.FindNameTranslation(sjisName.c_str(), nullptr);
-
-                if (tlUtf8) {
-                    std::string sjis = Encoding::Utf8ToSjis(tlUtf8->c_str());
-                    if (!sjis.empty()) {
-                        finalName = g_stringPool.Store(sjis);
-                        if (Config::enableTextLogging) {
-                            Log("[SAY] CharID %d (%s) -> %s\n", charId, origName.c_str(), tlUtf8->c_str());
+    WaitForTranslations();
+    {
+        TranslationDB::ReadGuard guard(g_translationDB);  // Keeps the entries alive until they are rendered
+
+        // Resolve message and its speaker together
+        bool inlineName = name && *name;
+        TranslationDB::Line line = g_translationDB.LookupLine(inlineName ? name : nullptr, message);
+
+        // If name is NULL, look up by CharID
+        if (!inlineName && pThis) {
+            int charId = *((int*)((uintptr_t)pThis + 4));
+
+            if (charId > 0) {
+                // Step 1: CharID → original name
+                auto it = g_charIdToName.find(charId);
+                if (it != g_charIdToName.end()) {
+                    const std::string& origName = it->second.utf8;
+                    const std::string& sjisName = it->second.sjis;
+
+                    // Step 2: original name → translation (via unique_names.tsv)
+                    const TranslationDB::Translation* tl = g_translationDB.FindNameTranslation(sjisName.c_str());
+
+                    if (tl) {
+                        if (const char* sjis = Render::Plain(*tl)) {
+                            finalName = sjis;
+                            if (LogEnabled(LogCategory::Say)) {
+                                Log(LogCategory::Say, "[SAY] CharID %d (%s) -> %s\n", charId, origName.c_str(), tl->Text().data());
+                            }
                         }
+                    } else {
+                        // No translation, use original name (char table lives for the whole session)
+                        finalName = sjisName.c_str();
                     }
-                } else {
-                    // No translation, use original name
-                    finalName = g_stringPool.Store(sjisName);
                 }
             }
         }
-    }
-    // Translate inline name
-    else if (name && *name) {
-        const std::string* tlUtf8 = g_translationDB.FindNameTranslation(name, message);
-        if (tlUtf8) {
-            std::string sjis = Encoding::Utf8ToSjis(tlUtf8->c_str());
-            if (!sjis.empty()) {
-                finalName = g_stringPool.Store(sjis);
+        // Translate inline name
+        else if (line.name) {
+            if (const char* sjis = Render::Plain(*line.name)) {
+                finalName = sjis;
             }
         }
-    }
 
-    // Translate message
-    if (message && *message) {
-        const std::string* tlUtf8 = g_translationDB.FindMessageTranslation(message);
-        if (tlUtf8) {
-            std::string normalized = TextFix::NormalizeUtf8(*tlUtf8);
-            std::string sjis = Encoding::Utf8ToSjis(normalized.c_str());
-            if (!sjis.empty()) {
-                std::string wrapped = WordWrap::Wrap(sjis, Config::wordWrapWidth);
-                finalMsg = g_stringPool.Store(wrapped);
+        // Translate message
+        if (line.message) {
+            if (const char* sjis = Render::Message(*line.message)) {
+                finalMsg = sjis;
             }
         }
     }
 
     // Log
-    if (Config::enableTextLogging) {
+    if (LogEnabled(LogCategory::Say)) {
         std::string nameUtf8 = name ? Encoding::SjisToUtf8(name) : "(null)";
         std::string msgUtf8 = message ? Encoding::SjisToUtf8(message) : "(null)";
 
-        Log("[SAY] voiceId=%d flags=0x%08X\n", voiceId, flags);
-        Log("      name=\"%s\"\n", nameUtf8.c_str());
-        Log("      msg=\"%s\"\n", msgUtf8.c_str());
+        Log(LogCategory::Say, "[SAY] voiceId=%d flags=0x%08X\n", voiceId, flags);
+        Log(LogCategory::Say, "      name=\"%s\"\n", nameUtf8.c_str());
+        Log(LogCategory::Say, "      msg=\"%s\"\n", msgUtf8.c_str());
 
         if (finalName != name || finalMsg != message) {
             std::string tlNameUtf8 = finalName ? Encoding::SjisToUtf8(finalName) : "";
             std::string tlMsgUtf8 = finalMsg ? Encoding::SjisToUtf8(finalMsg) : "";
-            Log("  --> name=\"%s\"\n", tlNameUtf8.c_str());
-            Log("  --> msg=\"%s\"\n", tlMsgUtf8.c_str());
+            Log(LogCategory::Say, "  --> name=\"%s\"\n", tlNameUtf8.c_str());
+            Log(LogCategory::Say, "  --> msg=\"%s\"\n", tlMsgUtf8.c_str());
         }
     }
 
-    g_origAdvCharSay(pThis, voiceId, finalName, finalMsg, flag, flags, p1, p2, p3, printParam);
+    perf.Original([&] { g_origAdvCharSay(pThis, voiceId, finalName, finalMsg, flag, flags, p1, p2, p3, printParam); });
 }
 
 //=============================================================================
@@ -1362,21 +1400,21 @@ static void __fastcall PrintEx_Hook(
     int charId, int msgId, const char* name, const char* message,
     unsigned long flags, unsigned long linkData)
 {
+    Perf::Scope perf(Perf::kPrintEx);
     const char* finalMsg = message;
 
     if (message && *message) {
-        const std::string* tlUtf8 = g_translationDB.FindMessageTranslation(message);
-        if (tlUtf8) {
-            std::string normalized = TextFix::NormalizeUtf8(*tlUtf8);
-            std::string sjis = Encoding::Utf8ToSjis(normalized.c_str());
-            if (!sjis.empty()) {
-                std::string wrapped = WordWrap::Wrap(sjis, Config::wordWrapWidth); // Apply word wrapping
-                finalMsg = g_stringPool.Store(wrapped);
+        WaitForTranslations();
+        TranslationDB::ReadGuard guard(g_translationDB);
+        const TranslationDB::Translation* tl = g_translationDB.FindMessageTranslation(message);
+        if (tl) {
+            if (const char* sjis = Render::Message(*tl)) { // Normalized + word wrapped
+                finalMsg = sjis;
             }
         }
     }
 
-    g_origPrintEx(pThis, charId, msgId, name, finalMsg, flags, linkData);
+    perf.Original([&] { g_origPrintEx(pThis, charId, msgId, name, finalMsg, flags, linkData); });
 }
 
 //=============================================================================
@@ -1393,63 +1431,80 @@ typedef int(__thiscall* Fn_SaveDataTitle)(
 );
 static Fn_SaveDataTitle g_origSaveDataTitle = nullptr;
 
+// The save/load screen asks for every visible slot's title on each refresh.
+// Answers are kept per slot and reused while the slot's label bytes and the
+// translation load are the same. Only the game thread draws save slots.
+namespace SaveTitles {
+    struct Entry {
+        uint64_t hash;         // FNV-1a of the label bytes
+        uint32_t generation;   // TranslationDB::LoadGeneration() it was resolved against
+        bool translated;
+        std::string sjis;      // Our own copy - pool strings can be retired between refreshes
+    };
+
+    static std::unordered_map<uint64_t, Entry> g_slots;
+
+    // Translated SJIS title for the slot, or nullptr to keep the original
+    static const char* Resolve(int slotType, int slotIndex, const char* labelSjis) {
+        uint64_t hash = HashBytes(kHashSeed, labelSjis);
+        uint32_t generation = g_translationDB.LoadGeneration();
+
+        auto [it, added] = g_slots.try_emplace(((uint64_t)(uint32_t)slotType << 32) | (uint32_t)slotIndex);
+        Entry& entry = it->second;
+        if (!added && entry.hash == hash && entry.generation == generation) {
+            return entry.translated ? entry.sjis.c_str() : nullptr;
+        }
+
+        WaitForTranslations();
+        entry = { hash, generation, false, std::string() };
+
+        TranslationDB::ReadGuard guard(g_translationDB);
+        const TranslationDB::Translation* translated = g_translationDB.FindLabelTranslation(labelSjis);
+        if (translated) {
+            if (const char* sjis = Render::Plain(*translated)) {
+                entry.sjis = sjis;
+                entry.translated = true;
+            }
+        }
+
+        if (LogEnabled(LogCategory::Save)) {
+            Log(LogCategory::Save, "[SAVE] Slot %d/%d: \"%s\" -> %s\n", slotType, slotIndex,
+                Encoding::SjisToUtf8(labelSjis).c_str(), translated ? translated->Text().data() : "(no translation)");
+        }
+        return entry.translated ? entry.sjis.c_str() : nullptr;
+    }
+}
+
 static int __fastcall SaveDataTitle_Hook(
     void* pThis, void* edx,
     void* fcString, int slotType, int slotIndex, bool useTemplate, unsigned int* outTime)
 {
-    // Debug
-    Log("[SAVE] title() called: type=%d index=%d\n", slotType, slotIndex);
-
-    // Check valid
-    if (!g_SaveDataIsValid(pThis, slotType, slotIndex)) {
-        Log("[SAVE] Invalid slot\n");
-        return g_origSaveDataTitle(pThis, fcString, slotType, slotIndex, useTemplate, outTime);
-    }
+    Perf::Scope perf(Perf::kSaveDataTitle);
+    auto callOriginal = [&] {
+        return perf.Original([&] { return g_origSaveDataTitle(pThis, fcString, slotType, slotIndex, useTemplate, outTime); });
+    };
 
+    // Invalid or empty slot - nothing to translate
+    if (!g_SaveDataIsValid(pThis, slotType, slotIndex)) return callOriginal();
     DWORD* item = (DWORD*)g_SaveDataGetItem(pThis, slotType, slotIndex);
-
-    // Empty slot - call original
-    if (item[0] == 0) {
-        Log("[SAVE] Empty slot\n");
-        return g_origSaveDataTitle(pThis, fcString, slotType, slotIndex, useTemplate, outTime);
-    }
+    if (item[0] == 0) return callOriginal();
 
     // Get label
     DWORD labelFCString = item[2];
     const char* labelSjis = *(const char**)(labelFCString + 0x14);
-    Log("[SAVE] Label raw: %p -> \"%s\"\n", labelSjis, labelSjis ? Encoding::SjisToUtf8(labelSjis).c_str() : "(null)");
-
-    // Try translate
-    const char* finalLabel = labelSjis;
-    std::string translatedSjis;
+    if (!labelSjis || !*labelSjis) return callOriginal();
 
-    if (labelSjis && *labelSjis) {
-        // Track current label for scene info
-        {
-            std::lock_guard<std::mutex> lock(g_sceneMutex);
-            g_currentLabel = Encoding::SjisToUtf8(labelSjis);
-        }
-
-        const std::string* translated = g_translationDB.FindLabelTranslation(labelSjis);
-
-        if (translated) {
-            translatedSjis = Encoding::Utf8ToSjis(translated->c_str());
-            finalLabel = translatedSjis.c_str();
-            Log("[SAVE] Found translation: \"%s\"\n", translated->c_str());
-        } else {
-            Log("[SAVE] No translation found!\n");
-        }
-    }
+    const char* finalLabel = SaveTitles::Resolve(slotType, slotIndex, labelSjis);
+    if (!finalLabel) return callOriginal();
 
     // Temporarily replace the label in the item
-    const char* originalPtr = *(const char**)(labelFCString + 0x14);
     *(const char**)(labelFCString + 0x14) = finalLabel;
 
     // Call original
-    int result = g_origSaveDataTitle(pThis, fcString, slotType, slotIndex, useTemplate, outTime);
+    int result = callOriginal();
 
     // Restore original
-    *(const char**)(labelFCString + 0x14) = originalPtr;
+    *(const char**)(labelFCString + 0x14) = labelSjis;
 
     return result;
 }
@@ -1465,17 +1520,18 @@ static void __fastcall PrepareQuestion_Hook(void* pThis, void* edx, int choiceId
     const char* finalText = text;
 
     if (text && *text) {
-        const std::string* translated = g_translationDB.FindMessageTranslation(text);
+        WaitForTranslations();
+        TranslationDB::ReadGuard guard(g_translationDB);
+        const TranslationDB::Translation* translated = g_translationDB.FindMessageTranslation(text);
         if (translated) {
-            std::string sjis = Encoding::Utf8ToSjis(translated->c_str());
-            if (!sjis.empty()) {
-                finalText = g_stringPool.Store(sjis);
+            if (const char* sjis = Render::Plain(*translated)) {
+                finalText = sjis;
 
-                if (Config::enableTextLogging) {
-                    Log("[CHOICE] %d: \"%s\" -> \"%s\"\n",
+                if (LogEnabled(LogCategory::Say)) {
+                    Log(LogCategory::Say, "[CHOICE] %d: \"%s\" -> \"%s\"\n",
                         choiceId,
                         Encoding::SjisToUtf8(text).c_str(),
-                        translated->c_str());
+                        translated->Text().data());
                 }
             }
         }
@@ -1484,6 +1540,96 @@ static void __fastcall PrepareQuestion_Hook(void* pThis, void* edx, int choiceId
     g_origPrepareQuestion(pThis, choiceId, finalText);
 }
 
+//=============================================================================
+// Scene Script Loader
+//=============================================================================
+// liteLoad() names the .rld about to run. Decrypting and parsing it happens
+// here, off the game thread, and the result is handed to the database to bind.
+// Binding reads the scene's shard; the scenes it can change to are read next.
+namespace SceneLoader {
+    struct Job {
+        std::string fileId;
+        std::string path;
+        uint64_t sequence;
+    };
+
+    static std::deque<Job> g_jobs;
+    static std::mutex g_mutex;
+    static uint64_t g_sequence = 0;  // Bumped by every Queue, under g_mutex
+    static HANDLE g_event = nullptr;
+    static HANDLE g_thread = nullptr;
+    static std::atomic<bool> g_stopping{false};
+
+    static DWORD WINAPI ThreadProc(LPVOID) {
+        while (!g_stopping.load(std::memory_order_acquire)) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(g_mutex);
+                if (g_jobs.empty()) {
+                    lock.unlock();
+                    WaitForSingleObject(g_event, INFINITE);
+                    continue;
+                }
+                // Only the newest scene matters
+                job = std::move(g_jobs.back());
+                g_jobs.clear();
+            }
+
+            auto script = std::make_shared<RldScript::Script>();
+            if (!RldScript::Load(job.path.c_str(), *script)) {
+                Log("[TL] Could not read %s - matching by text only\n", job.path.c_str());
+                g_translationDB.Prefetch({ job.fileId });
+                continue;
+            }
+
+            // A scene queued meanwhile supersedes this one. Binding waits out a
+            // reload, so it runs without g_mutex - Queue is on the game thread.
+            auto superseded = [&] {
+                std::lock_guard<std::mutex> lock(g_mutex);
+                return g_sequence != job.sequence;
+            };
+            if (superseded()) continue;
+
+            std::vector<std::string> successors = script->successors;
+            g_translationDB.SetSceneScript(job.fileId, std::move(script));
+
+            // Queue cleared the scene before we bound it; only this thread binds, so undo ours
+            {
+                std::lock_guard<std::mutex> lock(g_mutex);
+                if (g_sequence != job.sequence) {
+                    g_translationDB.ClearSceneScript();
+                    continue;
+                }
+            }
+            g_translationDB.Prefetch(successors);
+        }
+        return 0;
+    }
+
+    static void Queue(const std::string& fileId, const char* path) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_translationDB.ClearSceneScript();
+        if (!g_thread) return;
+
+        g_jobs.push_back({ fileId, path, ++g_sequence });
+        SetEvent(g_event);
+    }
+
+    static void Start() {
+        g_event = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        g_thread = CreateThread(nullptr, 0, ThreadProc, nullptr, 0, nullptr);
+    }
+
+    static void Stop() {
+        if (!g_thread) return;
+        g_stopping.store(true, std::memory_order_release);
+        SetEvent(g_event);
+        WaitForSingleObject(g_thread, 1000);
+        CloseHandle(g_thread);
+        g_thread = nullptr;
+    }
+}
+
 //=============================================================================
 // Hook: RetouchSystem::liteLoad() - Scene Tracking
 //=============================================================================
@@ -1549,7 +1695,10 @@ static char __fastcall LiteLoad_Hook(void* pThis, void* edx, const char* path, u
         {
             std::lock_guard<std::mutex> lock(g_sceneMutex);
             g_currentFile = filename;
+            g_translationDB.NoteScene(filename);
             g_currentLabel.clear();
+            g_currentScene.store(nullptr, std::memory_order_relaxed);
+            g_stringPool.OnSceneTransition();
 
             // Map filename to friendly name for Discord RPC
             std::string display;
@@ -1573,6 +1722,7 @@ static char __fastcall LiteLoad_Hook(void* pThis, void* edx, const char* path, u
         }
 
         Log("[LOAD] %s\n", filename.c_str());
+        SceneLoader::Queue(filename, finalPath);
     }
 
     return g_origLiteLoad(pThis, finalPath, flags);
@@ -1608,147 +1758,438 @@ typedef DWORD(WINAPI* Fn_GetGlyphOutlineA)(
 );
 static Fn_GetGlyphOutlineA g_origGetGlyphOutlineA = nullptr;
 
-static DWORD WINAPI GetGlyphOutlineA_Hook(
-    HDC hdc, UINT uChar, UINT fuFormat,
-    LPGLYPHMETRICS lpgm, DWORD cjBuffer,
-    LPVOID pvBuffer, const MAT2* lpmat2)
-{
-    DWORD result = g_origGetGlyphOutlineA(hdc, uChar, fuFormat, lpgm, cjBuffer, pvBuffer, lpmat2);
-
-    // Fix negative origin.x
-    if (lpgm && pvBuffer && result != GDI_ERROR) {
-        if (lpgm->gmptGlyphOrigin.x < 0) {
-            int offset = -lpgm->gmptGlyphOrigin.x;
-            lpgm->gmptGlyphOrigin.x = 0;
-            lpgm->gmCellIncX += offset;
-        }
+// Fix negative origin.x
+static void FixGlyphOrigin(GLYPHMETRICS& metrics) {
+    if (metrics.gmptGlyphOrigin.x < 0) {
+        int offset = -metrics.gmptGlyphOrigin.x;
+        metrics.gmptGlyphOrigin.x = 0;
+        metrics.gmCellIncX += offset;
     }
-
-    return result;
 }
 
-//=============================================================================
-// Font Replacement Hook
-//=============================================================================
-typedef HFONT(WINAPI* Fn_CreateFontIndirectA)(const LOGFONTA*);
-static Fn_CreateFontIndirectA g_origCreateFontIndirectA = nullptr;
+// The engine asks for every glyph each time it draws and GDI rasterizes it again,
+// so keep what GDI returned (origin already fixed) in a bounded LRU. The engine
+// sizes a glyph, then fetches it; both calls are answered from the same entry.
+namespace GlyphCache {
+    struct Key {
+        HFONT font;
+        UINT glyph;
+        UINT format;
+        MAT2 matrix;
 
-static HFONT WINAPI CreateFontIndirectA_Hook(const LOGFONTA* lf) {
-    if (lf) {
-        LOGFONTA modified = *lf;
+        bool operator==(const Key& other) const {
+            return font == other.font && glyph == other.glyph && format == other.format &&
+                memcmp(&matrix, &other.matrix, sizeof(MAT2)) == 0;
+        }
+    };
 
-        std::string origName = Encoding::SjisToUtf8(lf->lfFaceName);
-        const char* newFont = nullptr;
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            size_t hash = std::hash<const void*>()(key.font);
+            hash = hash * 31 + key.glyph;
+            hash = hash * 31 + key.format;
+            const uint32_t* matrix = (const uint32_t*)&key.matrix;
+            for (size_t i = 0; i < sizeof(MAT2) / sizeof(uint32_t); i++) hash = hash * 31 + matrix[i];
+            return hash;
+        }
+    };
 
-        // Check for proportional (Ｐ in SJIS = 0x820x6F)
-        bool isProportional = (strstr(lf->lfFaceName, "\x82\x6F") != nullptr);
+    struct Glyph {
+        Key key;
+        GLYPHMETRICS metrics;       // As GDI returned them - what a sizing call gets
+        GLYPHMETRICS fixedMetrics;  // Origin fixed - what a call with a buffer gets
+        DWORD size = GDI_ERROR;     // Sizing call result, GDI_ERROR until seen
+        DWORD result = GDI_ERROR;   // Buffer call result, GDI_ERROR until seen
+        std::vector<uint8_t> data;  // 'size' bytes, valid once result is set
+    };
 
-        if (isProportional) {
-            // Proportional font
-            if (Config::fontNameProportional[0] != '\0') {
-                newFont = Config::fontNameProportional;
-            } else if (Config::fontName[0] != '\0') {
-                newFont = Config::fontName;  // Fallback to main
-            } else {
-                newFont = "MS PGothic";  // Default
+    static std::mutex g_mutex;
+    static std::list<Glyph> g_lru;  // Most recently used first
+    static std::unordered_map<Key, std::list<Glyph>::iterator, KeyHash> g_index;
+    static size_t g_bytes = 0;
+    static uint64_t g_hits = 0;
+    static uint64_t g_misses = 0;
+
+    static bool MakeKey(HDC hdc, UINT glyph, UINT format, const MAT2* matrix, Key& key) {
+        if (!matrix) return false;
+        key.font = (HFONT)GetCurrentObject(hdc, OBJ_FONT);
+        if (!key.font) return false;
+        key.glyph = glyph;
+        key.format = format;
+        key.matrix = *matrix;
+        return true;
+    }
+
+    // Answer the call from the cache; false means ask GDI
+    static bool Lookup(const Key& key, LPGLYPHMETRICS metrics, DWORD bufferSize, LPVOID buffer,
+        DWORD& result) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_index.find(key);
+        if (it == g_index.end()) {
+            g_misses++;
+            return false;
+        }
+
+        Glyph& glyph = *it->second;
+        if (buffer && bufferSize > 0) {
+            if (glyph.result == GDI_ERROR || bufferSize < glyph.data.size()) {
+                g_misses++;
+                return false;
             }
+            memcpy(buffer, glyph.data.data(), glyph.data.size());
+            result = glyph.result;
         } else {
-            // Non-proportional font
-            if (Config::fontName[0] != '\0') {
-                newFont = Config::fontName;
-            } else {
-                newFont = "MS Gothic";  // Default
+            if (glyph.size == GDI_ERROR) {
+                g_misses++;
+                return false;
             }
+            result = glyph.size;
         }
 
-        Log("[FONT] %s (h=%d, cs=%d) -> %s (cs=128)\n", origName.c_str(), lf->lfHeight, lf->lfCharSet, newFont);
-
-        strcpy_s(modified.lfFaceName, newFont);
-        modified.lfCharSet = SHIFTJIS_CHARSET;
-        return g_origCreateFontIndirectA(&modified);
+        *metrics = buffer ? glyph.fixedMetrics : glyph.metrics;
+        g_lru.splice(g_lru.begin(), g_lru, it->second);
+        g_hits++;
+        return true;
     }
-    return g_origCreateFontIndirectA(lf);
-}
 
-//=============================================================================
-// Hook: CreateFileA - Asset Redirection
-//=============================================================================
-typedef HANDLE(WINAPI* Fn_CreateFileA)(LPCSTR lpFileName, DWORD dwDesiredAccess, DWORD dwShareMode,
-    LPSECURITY_ATTRIBUTES lpSecurity, DWORD dwCreation,
-    DWORD dwFlags, HANDLE hTemplate
-);
-static Fn_CreateFileA g_origCreateFileA = nullptr;
+    // Record a successful GDI call; rawMetrics is from before the origin fix
+    static void Store(const Key& key, const GLYPHMETRICS& rawMetrics, DWORD bufferSize, LPVOID buffer,
+        DWORD result) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_index.find(key);
+        if (it == g_index.end()) {
+            g_lru.emplace_front();
+            g_lru.front().key = key;
+            it = g_index.emplace(key, g_lru.begin()).first;
+        } else {
+            g_lru.splice(g_lru.begin(), g_lru, it->second);
+        }
 
-static HANDLE WINAPI CreateFileA_Hook(
-    LPCSTR lpFileName, DWORD dwDesiredAccess, DWORD dwShareMode,
-    LPSECURITY_ATTRIBUTES lpSecurity, DWORD dwCreation,
-    DWORD dwFlags, HANDLE hTemplate)
-{
-    if (lpFileName && (dwDesiredAccess & GENERIC_READ)) {
-        const char* ext = strrchr(lpFileName, '.');
-        if (ext && _stricmp(ext, ".gyu") == 0) {
-            std::string replacement = AssetRedirect::FindReplacement(lpFileName);
-            if (!replacement.empty()) {
-                if (Config::logAssetRedirects) {
-                    Log("[ASSET] %s -> %s\n", lpFileName, replacement.c_str());
-                }
-                return g_origCreateFileA(
-                    replacement.c_str(), dwDesiredAccess, dwShareMode,
-                    lpSecurity, dwCreation, dwFlags, hTemplate
-                );
+        Glyph& glyph = *it->second;
+        glyph.metrics = rawMetrics;
+        glyph.fixedMetrics = rawMetrics;
+        FixGlyphOrigin(glyph.fixedMetrics);
+
+        if (!buffer || bufferSize == 0) {
+            glyph.size = result;
+        } else if (glyph.size != GDI_ERROR && glyph.size <= bufferSize) {
+            // Without a sizing call first there's no telling how much GDI wrote
+            g_bytes -= glyph.data.size();
+            glyph.data.assign((const uint8_t*)buffer, (const uint8_t*)buffer + glyph.size);
+            g_bytes += glyph.data.size();
+            glyph.result = result;
+        }
+
+        while (g_lru.size() > Constants::kGlyphCacheEntries ||
+            (g_bytes > Constants::kGlyphCacheBytes && g_lru.size() > 1)) {
+            g_bytes -= g_lru.back().data.size();
+            g_index.erase(g_lru.back().key);
+            g_lru.pop_back();
+        }
+    }
+
+    // A new font can reuse a deleted font's handle, so drop whatever was cached under it
+    static void ForgetFont(HFONT font) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (auto it = g_lru.begin(); it != g_lru.end(); ) {
+            if (it->key.font == font) {
+                g_bytes -= it->data.size();
+                g_index.erase(it->key);
+                it = g_lru.erase(it);
+            } else {
+                ++it;
             }
         }
     }
 
-    return g_origCreateFileA(
-        lpFileName, dwDesiredAccess, dwShareMode,
-        lpSecurity, dwCreation, dwFlags, hTemplate
-    );
+    static void PrintStats() {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        uint64_t total = g_hits + g_misses;
+        Log("[GLYPH] %u cached (%u KB), %llu hits / %llu calls (%.1f%%)\n",
+            (unsigned)g_lru.size(), (unsigned)(g_bytes / 1024), g_hits, total,
+            total ? 100.0 * g_hits / total : 0.0);
+    }
+}
+
+static DWORD WINAPI GetGlyphOutlineA_Hook(
+    HDC hdc, UINT uChar, UINT fuFormat,
+    LPGLYPHMETRICS lpgm, DWORD cjBuffer,
+    LPVOID pvBuffer, const MAT2* lpmat2)
+{
+    Perf::Scope perf(Perf::kGetGlyphOutlineA);
+
+    GlyphCache::Key key;
+    bool cacheable = lpgm && GlyphCache::MakeKey(hdc, uChar, fuFormat, lpmat2, key);
+    DWORD result;
+    if (cacheable && GlyphCache::Lookup(key, lpgm, cjBuffer, pvBuffer, result)) return result;
+
+    result = perf.Original([&] {
+        return g_origGetGlyphOutlineA(hdc, uChar, fuFormat, lpgm, cjBuffer, pvBuffer, lpmat2);
+    });
+    if (!lpgm || result == GDI_ERROR) return result;
+
+    if (cacheable) GlyphCache::Store(key, *lpgm, cjBuffer, pvBuffer, result);
+    if (pvBuffer) FixGlyphOrigin(*lpgm);
+    return result;
 }
 
 //=============================================================================
-// File Watcher
+// Font Replacement Hook
 //=============================================================================
-class FileWatcher {
-public:
-    void Start(const char* directory, const std::vector<std::string>& watchFiles, std::function<void()> onChange) {
-        m_watchFiles = watchFiles;
-        m_onChange = onChange;
-        m_running = true;
-
-        // Get full directory path
-        char fullPath[MAX_PATH];
-        GetFullPathNameA(directory, MAX_PATH, fullPath, nullptr);
-        m_directory = fullPath;
+typedef HFONT(WINAPI* Fn_CreateFontIndirectA)(const LOGFONTA*);
+typedef BOOL(WINAPI* Fn_DeleteObject)(HGDIOBJ);
+static Fn_CreateFontIndirectA g_origCreateFontIndirectA = nullptr;
+static Fn_DeleteObject g_origDeleteObject = nullptr;
 
-        m_lastWriteTime = GetLatestModTime();
-        m_thread = CreateThread(nullptr, 0, WatchThreadProc, this, 0, nullptr);
+static const char* ReplacementFace(bool proportional) {
+    if (proportional) {
+        if (Config::fontNameProportional[0] != '\0') return Config::fontNameProportional;
+        if (Config::fontName[0] != '\0') return Config::fontName;  // Fallback to main
+        return "MS PGothic";  // Default
     }
+    if (Config::fontName[0] != '\0') return Config::fontName;
+    return "MS Gothic";  // Default
+}
 
-    void Stop() {
-        m_running = false;
-        if (m_stopEvent) {
-            SetEvent(m_stopEvent);
-        }
-        if (m_thread) {
-            WaitForSingleObject(m_thread, 2000);
-            CloseHandle(m_thread);
-            m_thread = nullptr;
-        }
-        if (m_stopEvent) {
-            CloseHandle(m_stopEvent);
-            m_stopEvent = nullptr;
+// The game recreates the same few fonts on every menu open and window resize.
+// Hand back one shared HFONT per rewritten LOGFONT instead of a new GDI object
+// each time; DeleteObject on a shared font only drops a reference, and unused
+// fonts stay around for the next request until the cache is full.
+namespace FontCache {
+    struct Font {
+        LOGFONTA key;  // Face name zero-padded so the whole struct compares with memcmp
+        HFONT font;
+        int refs;      // Handed out and not yet passed to DeleteObject
+    };
+
+    static std::mutex g_mutex;
+    static std::vector<Font> g_fonts;
+    static std::atomic<size_t> g_count{0};  // Lets DeleteObject skip the lock while empty
+    static uint64_t g_hits = 0;
+
+    // Caller holds g_mutex
+    static Font* Find(const LOGFONTA& key) {
+        for (Font& font : g_fonts) {
+            if (memcmp(&font.key, &key, sizeof(LOGFONTA)) == 0) return &font;
         }
+        return nullptr;
     }
 
-private:
-    static DWORD WINAPI WatchThreadProc(LPVOID param) {
-        return ((FileWatcher*)param)->WatchThread();
+    // Caller holds g_mutex; makes room by evicting the oldest unused font, which
+    // the caller deletes once unlocked. False if every cached font is in use.
+    static bool Insert(const LOGFONTA& key, HFONT font, int refs, HFONT* evicted) {
+        *evicted = nullptr;
+        if (g_fonts.size() >= Constants::kFontCacheEntries) {
+            auto idle = std::find_if(g_fonts.begin(), g_fonts.end(), [](const Font& f) { return f.refs == 0; });
+            if (idle == g_fonts.end()) return false;
+            *evicted = idle->font;
+            g_fonts.erase(idle);
+        }
+        g_fonts.push_back({ key, font, refs });
+        g_count.store(g_fonts.size(), std::memory_order_release);
+        return true;
+    }
+
+    // Glyphs cached under the handle go first, before GDI can hand it out again
+    static void Destroy(HFONT font) {
+        GlyphCache::ForgetFont(font);
+        g_origDeleteObject(font);
+    }
+
+    // Cache a font created outside g_mutex with refs references. If another
+    // thread cached the same LOGFONT meanwhile, that one is shared and this one
+    // deleted. A font the full cache can't take is returned uncached, so
+    // DeleteObject frees it as usual - or deleted here if nobody holds it.
+    static HFONT Share(const LOGFONTA& key, HFONT font, int refs) {
+        HFONT result = font, discard = nullptr, evicted = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            if (Font* shared = Find(key)) {
+                shared->refs += refs;
+                result = shared->font;
+                discard = font;
+            } else if (!Insert(key, font, refs, &evicted) && refs == 0) {
+                result = nullptr;
+                discard = font;
+            }
+        }
+        if (discard) g_origDeleteObject(discard);
+        if (evicted) Destroy(evicted);
+        return result;
+    }
+
+    // True if object is a shared font, in which case the delete is absorbed
+    static bool Release(HGDIOBJ object) {
+        if (g_count.load(std::memory_order_acquire) == 0) return false;
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (Font& font : g_fonts) {
+            if (font.font != (HFONT)object) continue;
+            if (font.refs > 0) font.refs--;
+            return true;
+        }
+        return false;
+    }
+
+    static LOGFONTA Rewrite(const LOGFONTA& lf, const char* face) {
+        LOGFONTA key = lf;
+        memset(key.lfFaceName, 0, sizeof(key.lfFaceName));
+        strcpy_s(key.lfFaceName, face);
+        key.lfCharSet = SHIFTJIS_CHARSET;
+        return key;
+    }
+
+    // Create and realize both configured faces before the first text box needs
+    // them. The game's sizes aren't known yet, so this loads the faces into GDI
+    // rather than guessing the exact LOGFONTs it will ask for.
+    static void Prewarm() {
+        if (!g_origCreateFontIndirectA || !g_origDeleteObject) return;
+
+        HDC dc = CreateCompatibleDC(nullptr);
+        for (bool proportional : { false, true }) {
+            LOGFONTA lf = {};
+            lf.lfHeight = -Constants::kPrewarmFontHeight;
+            lf.lfWeight = FW_NORMAL;
+            LOGFONTA key = Rewrite(lf, ReplacementFace(proportional));
+            {
+                std::lock_guard<std::mutex> lock(g_mutex);
+                if (Find(key)) continue;
+            }
+
+            HFONT font = g_origCreateFontIndirectA(&key);
+            if (!font) continue;
+            if (dc) {
+                HGDIOBJ previous = SelectObject(dc, font);
+                TEXTMETRICA metrics;
+                GetTextMetricsA(dc, &metrics);
+                SelectObject(dc, previous);
+            }
+            GlyphCache::ForgetFont(font);
+            if (Share(key, font, 0)) Log(LogCategory::Font, "[FONT] Prewarmed %s\n", key.lfFaceName);
+        }
+        if (dc) DeleteDC(dc);
     }
 
-    DWORD WatchThread() {
-        m_stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
-        HANDLE hDir = CreateFileA(
+    static void PrintStats() {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        int inUse = 0;
+        for (const Font& font : g_fonts) inUse += (font.refs > 0);
+        Log("[FONT] %u shared fonts (%d in use), %llu creations avoided\n",
+            (unsigned)g_fonts.size(), inUse, g_hits);
+    }
+}
+
+static HFONT WINAPI CreateFontIndirectA_Hook(const LOGFONTA* lf) {
+    Perf::Scope perf(Perf::kCreateFontIndirectA);
+    if (!lf) return perf.Original([&] { return g_origCreateFontIndirectA(lf); });
+
+    // Check for proportional (Ｐ in SJIS = 0x820x6F)
+    bool isProportional = (strstr(lf->lfFaceName, "\x82\x6F") != nullptr);
+    const char* newFont = ReplacementFace(isProportional);
+    LOGFONTA modified = FontCache::Rewrite(*lf, newFont);
+
+    {
+        std::lock_guard<std::mutex> lock(FontCache::g_mutex);
+        if (FontCache::Font* shared = FontCache::Find(modified)) {
+            shared->refs++;
+            FontCache::g_hits++;
+            return shared->font;
+        }
+    }
+
+    if (LogEnabled(LogCategory::Font)) {
+        std::string origName = Encoding::SjisToUtf8(lf->lfFaceName);
+        Log(LogCategory::Font, "[FONT] %s (h=%d, cs=%d) -> %s (cs=128)\n", origName.c_str(), lf->lfHeight, lf->lfCharSet, newFont);
+    }
+
+    // GDI can take a while to realize a font - don't hold up the other callers
+    HFONT font = perf.Original([&] { return g_origCreateFontIndirectA(&modified); });
+    if (font) {
+        GlyphCache::ForgetFont(font);
+        if (g_origDeleteObject) font = FontCache::Share(modified, font, 1);
+    }
+    return font;
+}
+
+static BOOL WINAPI DeleteObject_Hook(HGDIOBJ object) {
+    if (FontCache::Release(object)) return TRUE;
+
+    // Fonts that never went through the cache were glyph-cached under their
+    // handle too, and GDI may hand the same value to the next font
+    if (GetObjectType(object) == OBJ_FONT) GlyphCache::ForgetFont((HFONT)object);
+    return g_origDeleteObject(object);
+}
+
+//=============================================================================
+// Hook: CreateFileA - Asset Redirection
+//=============================================================================
+typedef HANDLE(WINAPI* Fn_CreateFileA)(LPCSTR lpFileName, DWORD dwDesiredAccess, DWORD dwShareMode,
+    LPSECURITY_ATTRIBUTES lpSecurity, DWORD dwCreation,
+    DWORD dwFlags, HANDLE hTemplate
+);
+static Fn_CreateFileA g_origCreateFileA = nullptr;
+
+static HANDLE WINAPI CreateFileA_Hook(
+    LPCSTR lpFileName, DWORD dwDesiredAccess, DWORD dwShareMode,
+    LPSECURITY_ATTRIBUTES lpSecurity, DWORD dwCreation,
+    DWORD dwFlags, HANDLE hTemplate)
+{
+    Perf::Scope perf(Perf::kCreateFileA);
+    if (lpFileName && (dwDesiredAccess & GENERIC_READ)) {
+        const char* ext = strrchr(lpFileName, '.');
+        if (ext && _stricmp(ext, ".gyu") == 0) {
+            std::string replacement = AssetRedirect::FindReplacement(lpFileName);
+            if (replacement.size() > 4 && _stricmp(replacement.c_str() + replacement.size() - 4, ".png") == 0) {
+                replacement = AssetRedirect::ResolvePng(lpFileName, replacement);
+            }
+            if (!replacement.empty()) {
+                if (Config::logAssetRedirects) {
+                    Log(LogCategory::Asset, "[ASSET] %s -> %s\n", lpFileName, replacement.c_str());
+                }
+                return perf.Original([&] {
+                    return g_origCreateFileA(
+                        replacement.c_str(), dwDesiredAccess, dwShareMode,
+                        lpSecurity, dwCreation, dwFlags, hTemplate
+                    );
+                });
+            }
+        }
+    }
+
+    return perf.Original([&] {
+        return g_origCreateFileA(
+            lpFileName, dwDesiredAccess, dwShareMode,
+            lpSecurity, dwCreation, dwFlags, hTemplate
+        );
+    });
+}
+
+//=============================================================================
+// File Watcher
+//=============================================================================
+// Overlapped ReadDirectoryChangesW, driven by the service thread: it waits on
+// Event(), calls OnSignaled() when a change lands and RunIfDue() once the
+// debounce has passed. Open() and Close() belong on that thread as well -
+// a pending directory read is cancelled when the thread that issued it exits.
+class FileWatcher {
+public:
+    // Empty watchFiles = react to any change below directory (which then needs recursive)
+    void Configure(const char* directory, const std::vector<std::string>& watchFiles, std::function<void()> onChange,
+        bool recursive = false) {
+        m_watchFiles = watchFiles;
+        m_onChange = onChange;
+        m_recursive = recursive;
+
+        // Get full directory path
+        char fullPath[MAX_PATH];
+        GetFullPathNameA(directory, MAX_PATH, fullPath, nullptr);
+        m_directory = fullPath;
+    }
+
+    bool Open() {
+        if (m_directory.empty()) return false;
+
+        m_dir = CreateFileA(
             m_directory.c_str(),
             FILE_LIST_DIRECTORY,
             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
@@ -1758,9 +2199,9 @@ private:
             nullptr
         );
 
-        if (hDir == INVALID_HANDLE_VALUE) {
+        if (m_dir == INVALID_HANDLE_VALUE) {
             Log("[FileWatcher] Failed to open directory: %s\n", m_directory.c_str());
-            return 1;
+            return false;
         }
 
         Log("[FileWatcher] Watching directory: %s\n", m_directory.c_str());
@@ -1768,67 +2209,116 @@ private:
             Log("[FileWatcher]   - %s\n", f.c_str());
         }
 
-        char buffer[4096];
-        OVERLAPPED overlapped = {};
-        overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        m_overlapped = {};
+        m_overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        m_lastWriteTime = GetLatestModTime();
+        if (!Issue()) {
+            Close();
+            return false;
+        }
+        return true;
+    }
 
-        HANDLE waitHandles[2] = { overlapped.hEvent, m_stopEvent };
+    void Close() {
+        if (m_dir != INVALID_HANDLE_VALUE) {
+            if (m_pending) {
+                DWORD bytesReturned = 0;
+                CancelIoEx(m_dir, &m_overlapped);
+                GetOverlappedResult(m_dir, &m_overlapped, &bytesReturned, TRUE);  // The kernel is done with m_buffer
+                m_pending = false;
+            }
+            CloseHandle(m_dir);
+            m_dir = INVALID_HANDLE_VALUE;
+        }
+        if (m_overlapped.hEvent) {
+            CloseHandle(m_overlapped.hEvent);
+            m_overlapped.hEvent = nullptr;
+        }
+        m_dueTime = 0;
+    }
 
-        while (m_running) {
-            DWORD bytesReturned = 0;
-            ResetEvent(overlapped.hEvent);
+    bool IsOpen() const { return m_dir != INVALID_HANDLE_VALUE; }
+    HANDLE Event() const { return m_overlapped.hEvent; }
 
-            BOOL result = ReadDirectoryChangesW(
-                hDir, buffer, sizeof(buffer), FALSE,
-                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
-                &bytesReturned, &overlapped, nullptr
-            );
+    // A read completed: note whether it matters, then queue the next one
+    void OnSignaled(ULONGLONG now) {
+        DWORD bytesReturned = 0;
+        m_pending = false;
+        if (GetOverlappedResult(m_dir, &m_overlapped, &bytesReturned, FALSE) && Matches(bytesReturned)) {
+            m_dueTime = now + Constants::kFileWatcherDebounceMs;  // Each change pushes the debounce out
+        }
 
-            if (!result && GetLastError() != ERROR_IO_PENDING) break;
+        if (!Issue()) {
+            Log("[FileWatcher] Stopped watching %s\n", m_directory.c_str());
+            Close();
+        }
+    }
 
-            DWORD waitResult = WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE);
+    // Milliseconds until a debounced change is due, INFINITE if none is pending
+    DWORD TimeUntilDue(ULONGLONG now) const {
+        if (!m_dueTime) return INFINITE;
+        return (m_dueTime > now) ? (DWORD)(m_dueTime - now) : 0;
+    }
 
-            if (waitResult == WAIT_OBJECT_0) {
-                if (GetOverlappedResult(hDir, &overlapped, &bytesReturned, FALSE)) {
-                    FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*)buffer;
+    void RunIfDue(ULONGLONG now) {
+        if (!m_dueTime || now < m_dueTime) return;
+        m_dueTime = 0;
 
-                    bool shouldReload = false;do {
-                        std::wstring changedFileW(info->FileName, info->FileNameLength / sizeof(WCHAR));
-                        char changedFile[MAX_PATH];
-                        WideCharToMultiByte(CP_ACP, 0, changedFileW.c_str(), -1, changedFile, MAX_PATH, nullptr, nullptr);
+        // Whole-tree watch: adds, renames and deletes don't move a mod time
+        if (!m_watchFiles.empty()) {
+            FILETIME newTime = GetLatestModTime();
+            if (CompareFileTime(&newTime, &m_lastWriteTime) == 0) return;
+            m_lastWriteTime = newTime;
+        }
 
-                        // Check if it's one of our watched files
-                        for (auto& watchFile : m_watchFiles) {
-                            if (_stricmp(changedFile, watchFile.c_str()) == 0) {
-                                shouldReload = true;
-                                Log("[FileWatcher] %s changed\n", changedFile);
-                                break;
-                            }
-                        }
+        if (m_onChange) {
+            m_onChange();
+        }
+    }
 
-                        if (info->NextEntryOffset == 0) break;
-                        info = (FILE_NOTIFY_INFORMATION*)((char*)info + info->NextEntryOffset);
-                    } while (true);
-
-                    if (shouldReload) {
-                        Sleep(Constants::kFileWatcherDebounceMs);  // Debounce
-                        FILETIME newTime = GetLatestModTime();
-                        if (CompareFileTime(&newTime, &m_lastWriteTime) != 0) {
-                            m_lastWriteTime = newTime;
-                            if (m_onChange) {
-                                m_onChange();
-                            }
-                        }
-                    }
+private:
+    bool Issue() {
+        ResetEvent(m_overlapped.hEvent);
+
+        DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+        if (m_watchFiles.empty()) {
+            filter |= FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME;
+        }
+
+        BOOL result = ReadDirectoryChangesW(
+            m_dir, m_buffer, sizeof(m_buffer), m_recursive ? TRUE : FALSE,
+            filter, nullptr, &m_overlapped, nullptr
+        );
+
+        if (!result && GetLastError() != ERROR_IO_PENDING) return false;
+        m_pending = true;
+        return true;
+    }
+
+    bool Matches(DWORD bytesReturned) {
+        // No names means the buffer overflowed - assume the worst
+        if (m_watchFiles.empty() || bytesReturned == 0) return true;
+
+        FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*)m_buffer;
+        bool matched = false;
+        do {
+            std::wstring changedFileW(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            char changedFile[MAX_PATH];
+            WideCharToMultiByte(CP_ACP, 0, changedFileW.c_str(), -1, changedFile, MAX_PATH, nullptr, nullptr);
+
+            // Check if it's one of our watched files
+            for (auto& watchFile : m_watchFiles) {
+                if (_stricmp(changedFile, watchFile.c_str()) == 0) {
+                    matched = true;
+                    Log("[FileWatcher] %s changed\n", changedFile);
+                    break;
                 }
-            } else if (waitResult == WAIT_OBJECT_0 + 1) {
-                break;
             }
-        }
 
-        CloseHandle(overlapped.hEvent);
-        CloseHandle(hDir);
-        return 0;
+            if (info->NextEntryOffset == 0) break;
+            info = (FILE_NOTIFY_INFORMATION*)((char*)info + info->NextEntryOffset);
+        } while (true);
+        return matched;
     }
 
     FILETIME GetLatestModTime() {
@@ -1848,13 +2338,17 @@ private:
     std::vector<std::string> m_watchFiles;
     std::string m_directory;
     std::function<void()> m_onChange;
-    std::atomic<bool> m_running{false};
-    HANDLE m_thread = nullptr;
-    HANDLE m_stopEvent = nullptr;
+    bool m_recursive = false;
+    HANDLE m_dir = INVALID_HANDLE_VALUE;
+    OVERLAPPED m_overlapped = {};
+    bool m_pending = false;
+    DWORD m_buffer[1024];    // FILE_NOTIFY_INFORMATION needs DWORD alignment
+    ULONGLONG m_dueTime = 0;  // GetTickCount64() to act at, 0 = nothing pending
     FILETIME m_lastWriteTime = {};
 };
 
 static FileWatcher g_fileWatcher;
+static FileWatcher g_assetWatcher;  // Keeps the AssetRedirect manifest current
 
 //=============================================================================
 // Locale Independence Hooks
@@ -1944,6 +2438,206 @@ static UINT __cdecl GetCodePage_Hook() {
     return 932;
 }
 
+//=============================================================================
+// Hook Forward Declarations
+//=============================================================================
+typedef int(WINAPI* Fn_MultiByteToWideChar)(UINT, DWORD, LPCCH, int, LPWSTR, int);
+typedef int(WINAPI* Fn_WideCharToMultiByte)(UINT, DWORD, LPCWCH, int, LPSTR, int, LPCCH, LPBOOL);
+static Fn_MultiByteToWideChar g_origMultiByteToWideChar = nullptr;
+static Fn_WideCharToMultiByte g_origWideCharToMultiByte = nullptr;
+
+typedef HWND(WINAPI* Fn_CreateWindowExA)(DWORD, LPCSTR, LPCSTR, DWORD, int, int, int, int, HWND, HMENU, HINSTANCE, LPVOID);
+static Fn_CreateWindowExA g_origCreateWindowExA = nullptr;
+
+typedef BOOL(WINAPI* Fn_SetWindowTextA)(HWND, LPCSTR);
+static Fn_SetWindowTextA g_origSetWindowTextA = nullptr;
+
+static int WINAPI MultiByteToWideChar_Hook(UINT, DWORD, LPCCH, int, LPWSTR, int);
+static int WINAPI WideCharToMultiByte_Hook(UINT, DWORD, LPCWCH, int, LPSTR, int, LPCCH, LPBOOL);
+static HWND WINAPI CreateWindowExA_Hook(DWORD, LPCSTR, LPCSTR, DWORD, int, int, int, int, HWND, HMENU, HINSTANCE, LPVOID);
+static BOOL WINAPI SetWindowTextA_Hook(HWND, LPCSTR);
+
+typedef INT_PTR(WINAPI* Fn_DialogBoxParamA)(HINSTANCE, LPCSTR, HWND, DLGPROC, LPARAM);
+static Fn_DialogBoxParamA g_origDialogBoxParamA = nullptr;
+static INT_PTR WINAPI DialogBoxParamA_Hook(HINSTANCE, LPCSTR, HWND, DLGPROC, LPARAM);
+
+typedef HMODULE(WINAPI* Fn_LoadLibraryExA)(LPCSTR, HANDLE, DWORD);
+static Fn_LoadLibraryExA g_origLoadLibraryExA = nullptr;
+static HMODULE WINAPI LoadLibraryExA_Hook(LPCSTR, HANDLE, DWORD);
+
+//=============================================================================
+// Hook Registry
+//=============================================================================
+// Every MinHook hook is declared once in g_hooks. Install() creates one
+// group's hooks, queues them and commits with a single MH_ApplyQueued - one
+// freeze of the process's threads per group instead of one per hook. The
+// 'hook' console command flips any of them at runtime, to A/B its cost.
+namespace Hooks {
+    enum class Group {
+        Locale,    // From DllMain, before the game runs on
+        Loader,    // LoadLibraryExA, until resident.dll shows up
+        Deferred,  // From the init thread
+        Resident,  // resident.dll internals, at Offsets from its base
+    };
+
+    struct Hook {
+        const char* name;
+        Group group;
+        const wchar_t* module;  // API hooks: this module's export...
+        const char* proc;
+        uintptr_t offset;       // ...resident hooks: this offset instead
+        void* detour;
+        void** original;
+        const bool* toggle;     // INI switch, nullptr = always installed
+        const char* purpose;    // For the log
+        bool pinned = false;    // Stays on once installed - 'hook <name> off' refuses it
+        void* target = nullptr;
+        bool created = false;
+        bool enabled = false;
+    };
+
+    static Hook g_hooks[] = {
+        { "MultiByteToWideChar", Group::Locale, L"kernelbase", "MultiByteToWideChar", 0,
+            (void*)&MultiByteToWideChar_Hook, (void**)&g_origMultiByteToWideChar, nullptr, "CP_ACP -> CP932" },
+        { "WideCharToMultiByte", Group::Locale, L"kernelbase", "WideCharToMultiByte", 0,
+            (void*)&WideCharToMultiByte_Hook, (void**)&g_origWideCharToMultiByte, nullptr, "CP_ACP -> CP932" },
+        { "CreateWindowExA", Group::Locale, L"user32", "CreateWindowExA", 0,
+            (void*)&CreateWindowExA_Hook, (void**)&g_origCreateWindowExA, nullptr, "-> Unicode + DefWindowProcW" },
+        { "SetWindowTextA", Group::Locale, L"user32", "SetWindowTextA", 0,
+            (void*)&SetWindowTextA_Hook, (void**)&g_origSetWindowTextA, nullptr, "-> DefWindowProcW" },
+        { "GetACP", Group::Locale, L"kernel32", "GetACP", 0,
+            (void*)&GetACP_Hook, (void**)&g_origGetACP, nullptr, "-> 932 (Japanese)" },
+        { "GetOEMCP", Group::Locale, L"kernel32", "GetOEMCP", 0,
+            (void*)&GetOEMCP_Hook, (void**)&g_origGetOEMCP, nullptr, "-> 932 (Japanese)" },
+        { "CharPrevA", Group::Locale, L"user32", "CharPrevA", 0,
+            (void*)&CharPrevA_Hook, (void**)&g_origCharPrevA, nullptr, "-> SJIS" },
+        { "CharNextA", Group::Locale, L"user32", "CharNextA", 0,
+            (void*)&CharNextA_Hook, (void**)&g_origCharNextA, nullptr, "-> SJIS" },
+
+        { "LoadLibraryExA", Group::Loader, L"kernel32", "LoadLibraryExA", 0,
+            (void*)&LoadLibraryExA_Hook, (void**)&g_origLoadLibraryExA, nullptr, "waiting for resident.dll" },
+
+        { "DialogBoxParamA", Group::Deferred, L"user32", "DialogBoxParamA", 0,
+            (void*)&DialogBoxParamA_Hook, (void**)&g_origDialogBoxParamA, nullptr, "UI translation" },
+        { "OutputDebugStringA", Group::Deferred, L"kernel32", "OutputDebugStringA", 0,
+            (void*)&OutputDebugStringA_Hook, (void**)&g_origOutputDebugStringA, nullptr, "game debug -> console" },
+        { "GetGlyphOutlineA", Group::Deferred, L"gdi32", "GetGlyphOutlineA", 0,
+            (void*)&GetGlyphOutlineA_Hook, (void**)&g_origGetGlyphOutlineA, nullptr, "glyph cache" },
+        // Goes live in the same commit as CreateFontIndirectA, so shared fonts are never unguarded,
+        // and can't be switched off: the game would then really delete fonts others still share
+        { "DeleteObject", Group::Deferred, L"gdi32", "DeleteObject", 0,
+            (void*)&DeleteObject_Hook, (void**)&g_origDeleteObject, nullptr, "shared fonts", true },
+        { "CreateFontIndirectA", Group::Deferred, L"gdi32", "CreateFontIndirectA", 0,
+            (void*)&CreateFontIndirectA_Hook, (void**)&g_origCreateFontIndirectA, nullptr, "font replacement" },
+        { "CreateFileA", Group::Deferred, L"kernel32", "CreateFileA", 0,
+            (void*)&CreateFileA_Hook, (void**)&g_origCreateFileA, &Config::enableAssetRedirect, "asset redirection" },
+
+        { "calcIniValue", Group::Resident, nullptr, nullptr, Offsets::CalcIniValue,
+            (void*)&CalcIniValue_Hook, (void**)&g_origCalcIniValue, nullptr, "INI protection bypassed" },
+        { "say", Group::Resident, nullptr, nullptr, Offsets::AdvCharSay,
+            (void*)&AdvCharSay_Hook, (void**)&g_origAdvCharSay, nullptr, "RetouchAdvCharacter::say()" },
+        { "printEx", Group::Resident, nullptr, nullptr, Offsets::PrintEx,
+            (void*)&PrintEx_Hook, (void**)&g_origPrintEx, nullptr, "RetouchPrintManager::printEx()" },
+        { "saveTitle", Group::Resident, nullptr, nullptr, Offsets::SaveDataTitle,
+            (void*)&SaveDataTitle_Hook, (void**)&g_origSaveDataTitle, nullptr, "SaveDataTitle() - LABEL translation" },
+        { "prepareQuestion", Group::Resident, nullptr, nullptr, Offsets::PrepareQuestion,
+            (void*)&PrepareQuestion_Hook, (void**)&g_origPrepareQuestion, nullptr, "RetouchSystem::prepareQuestion() - choices" },
+        { "liteLoad", Group::Resident, nullptr, nullptr, Offsets::LiteLoad,
+            (void*)&LiteLoad_Hook, (void**)&g_origLiteLoad, nullptr, "RetouchSystem::liteLoad() - scene tracking" },
+        { "getCodePage", Group::Resident, nullptr, nullptr, Offsets::GetCodePage,
+            (void*)&GetCodePage_Hook, (void**)&g_origGetCodePage, nullptr, "codepage getter -> 932 (Japanese)" },
+    };
+
+    static std::mutex g_mutex;  // Installs come from DllMain, the init thread and the game thread
+
+    static Hook* Find(const std::string& name) {
+        for (Hook& hook : g_hooks) {
+            if (_stricmp(hook.name, name.c_str()) == 0) return &hook;
+        }
+        return nullptr;
+    }
+
+    // Create and enable one group; base is resident.dll's for Group::Resident.
+    // Returns how many hooks went live.
+    static int Install(Group group, uintptr_t base = 0) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+
+        int queued = 0, declared = 0;
+        for (Hook& hook : g_hooks) {
+            if (hook.group != group || hook.created) continue;
+            if (hook.toggle && !*hook.toggle) continue;
+            declared++;
+
+            MH_STATUS status;
+            if (hook.module) {
+                status = MH_CreateHookApiEx(hook.module, hook.proc, hook.detour, hook.original, &hook.target);
+            } else {
+                hook.target = (void*)(base + hook.offset);
+                status = MH_CreateHook(hook.target, hook.detour, hook.original);
+            }
+            if (status != MH_OK) {
+                Log("[HOOK] %s failed: %s\n", hook.name, MH_StatusToString(status));
+                continue;
+            }
+
+            hook.created = true;
+            if (MH_QueueEnableHook(hook.target) == MH_OK) queued++;
+        }
+        if (queued == 0) return 0;
+
+        // One thread freeze for the whole group
+        MH_STATUS status = MH_ApplyQueued();
+        if (status != MH_OK) {
+            Log("[HOOK] Enabling %d hooks failed: %s\n", queued, MH_StatusToString(status));
+            return 0;
+        }
+
+        for (Hook& hook : g_hooks) {
+            if (hook.group != group || !hook.created || hook.enabled) continue;
+            hook.enabled = true;
+            Log("[+] %s hooked at 0x%p (%s)\n", hook.name, hook.target, hook.purpose);
+        }
+        if (queued < declared) Log("[HOOK] %d of %d hooks in the group enabled\n", queued, declared);
+        return queued;
+    }
+
+    static bool Set(Hook& hook, bool enable) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!hook.created) return false;
+        if (hook.enabled == enable) return true;
+        if (hook.pinned) return false;
+
+        MH_STATUS status = enable ? MH_QueueEnableHook(hook.target) : MH_QueueDisableHook(hook.target);
+        if (status == MH_OK) status = MH_ApplyQueued();
+        if (status != MH_OK) {
+            Log("[HOOK] %s: %s\n", hook.name, MH_StatusToString(status));
+            return false;
+        }
+        hook.enabled = enable;
+        return true;
+    }
+
+    static bool Set(const char* name, bool enable) {
+        Hook* hook = Find(name);
+        return hook && Set(*hook, enable);
+    }
+
+    static bool IsPinned(const std::string& name) {
+        Hook* hook = Find(name);
+        return hook && hook->pinned;
+    }
+
+    static void PrintList() {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        Log("\n=== Hooks ===\n");
+        for (const Hook& hook : g_hooks) {
+            const char* state = !hook.created ? "not installed" : hook.enabled ? "on" : "off";
+            Log("  %-20s %-14s %s\n", hook.name, state, hook.purpose);
+        }
+        Log("=============\n\n");
+    }
+}
+
 //=============================================================================
 // Debug Console Commands
 //=============================================================================
@@ -1962,6 +2656,9 @@ static void ProcessDebugCommand(const std::string& cmd) {
         Log("  log on/off   - Toggle logging\n");
         Log("  goto <file> [block] - Jump to scene\n");
         Log("  list         - List common scenes\n");
+        Log("  perf [reset|csv <file>] - Hook timings ([Debug] Profile=true)\n");
+        Log("  coverage [csv <file>] - Texts shown and time spent per scene\n");
+        Log("  hook [<name> on|off] - List hooks, or switch one at runtime\n");
         Log("========================\n\n");
     } else if (verb == "debug") {
         std::string state;
@@ -1997,9 +2694,10 @@ static void ProcessDebugCommand(const std::string& cmd) {
         }
     } else if (verb == "stats") {
         g_translationDB.PrintStats();
+        GlyphCache::PrintStats();
+        FontCache::PrintStats();
     }
     else if (verb == "reload") {
-        g_stringPool.Clear();
         g_translationDB.Reload();
         Log("[*] Reloaded!\n");
     }
@@ -2069,118 +2767,321 @@ static void ProcessDebugCommand(const std::string& cmd) {
         Log("  Extras: yotuiro_omake\n");
         Log("==================\n\n");
     }
-    else if (!verb.empty()) {
-        Log("[?] Unknown command: %s (type 'help')\n", verb.c_str());
-    }
-}
-
-static DWORD WINAPI ConsoleInputThread(LPVOID) {
-    Log("[*] Debug console ready. Type 'help' for commands.\n\n");
+    else if (verb == "coverage") {
+        std::string action, path;
+        iss >> action;
+        std::getline(iss >> std::ws, path);
 
-    char buffer[256];
-    while (g_running) {
-        if (fgets(buffer, sizeof(buffer), stdin)) {
-            std::string cmd(buffer);
-            // Trim newline
-            while (!cmd.empty() && (cmd.back() == '\n' || cmd.back() == '\r')) {
-                cmd.pop_back();
+        if (action == "csv") {
+            if (path.empty()) path = ".\\tl\\coverage.csv";
+            if (g_translationDB.WriteCoverageCsv(path.c_str())) {
+                Log("[TL] Wrote %s\n", path.c_str());
+            } else {
+                Log("[TL] Cannot write %s\n", path.c_str());
             }
-            if (!cmd.empty()) {
-                ProcessDebugCommand(cmd);
+        } else {
+            g_translationDB.PrintCoverage();
+        }
+    }
+    else if (verb == "hook") {
+        std::string name, state;
+        iss >> name >> state;
+
+        if (name.empty()) {
+            Hooks::PrintList();
+        } else if (state != "on" && state != "off") {
+            Log("[HOOK] Usage: hook <name> on|off\n");
+        } else if (state == "off" && Hooks::IsPinned(name)) {
+            Log("[HOOK] %s can't be switched off at runtime\n", name.c_str());
+        } else if (Hooks::Set(name.c_str(), state == "on")) {
+            Log("[HOOK] %s %s\n", name.c_str(), state.c_str());
+        } else {
+            Log("[HOOK] %s is not an installed hook ('hook' lists them)\n", name.c_str());
+        }
+    }
+    else if (verb == "perf") {
+        std::string action, path;
+        iss >> action;
+        std::getline(iss >> std::ws, path);
+
+#ifndef YOTSUIRO_PROFILING
+        Log("[PERF] This build has no hook timers - configure with -DYOTSUIRO_PROFILING=ON\n");
+#else
+        if (!Config::enableProfiling) {
+            Log("[PERF] Profiling is off - set Profile=true under [Debug] and restart\n");
+        } else if (action == "reset") {
+            Perf::Reset();
+            Log("[PERF] Counters reset\n");
+        } else if (action == "csv") {
+            if (path.empty()) path = ".\\tl\\perf.csv";
+            if (Perf::WriteCsv(path.c_str())) {
+                Log("[PERF] Wrote %s\n", path.c_str());
+            } else {
+                Log("[PERF] Cannot write %s\n", path.c_str());
             }
+        } else {
+            Perf::Print();
         }
+#endif
+    }
+    else if (!verb.empty()) {
+        Log("[?] Unknown command: %s (type 'help')\n", verb.c_str());
     }
-    return 0;
 }
 
 //=============================================================================
-// Hook Installation
+// Service Thread
 //=============================================================================
-typedef HMODULE(WINAPI* Fn_LoadLibraryExA)(LPCSTR, HANDLE, DWORD);
-static Fn_LoadLibraryExA g_origLoadLibraryExA = nullptr;
-
-static bool InstallHooks(HMODULE hResident) {
-    uintptr_t base = (uintptr_t)hResident;
-    Log("[*] resident.dll base: 0x%p\n", (void*)base);
+// Hotkeys, file watching, the debug console and Discord callbacks all run on
+// this one thread, which sleeps in MsgWaitForMultipleObjectsEx until one of
+// them has work, so nothing wakes up while the game is idle. Hotkeys arrive
+// as raw input on a message-only window: RIDEV_INPUTSINK keeps them working
+// while the game is unfocused, as the old GetAsyncKeyState poll did, without
+// taking the keys from other programs the way RegisterHotKey would.
+namespace Service {
+    static const wchar_t* kWindowClass = L"YotsuiroTlService";
 
-    ForceCRTJapaneseCodepage();
+    static HANDLE g_thread = nullptr;
+    static HANDLE g_stopEvent = nullptr;
+    static FileWatcher* const g_watchers[] = { &g_fileWatcher, &g_assetWatcher };
 
-    // Hook calcIniValue - bypass INI checksum protection
-    {
-        uintptr_t addr = base + Offsets::CalcIniValue;
-        Log("[*] Hooking calcIniValue at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&CalcIniValue_Hook, (void**)&g_origCalcIniValue) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] calcIniValue hooked - INI protection bypassed!\n");
+    //-------------------------------------------------------------------------
+    // Hotkeys
+    //-------------------------------------------------------------------------
+    // Act on release, like the poll did after waiting for the key to come back up
+    static void OnKeyReleased(int key) {
+        if (key == Config::reloadHotkey) {
+            g_translationDB.Reload();
+            MessageBeep(MB_OK);
+        } else if (key == Config::statsHotkey) {
+            g_translationDB.PrintStats();
+            MessageBeep(MB_OK);
+        } else if (key == Config::logToggleHotkey) {
+            Config::enableTextLogging = !Config::enableTextLogging;
+            Log("[*] Text logging: %s\n", Config::enableTextLogging ? "ON" : "OFF");
+            MessageBeep(MB_OK);
         }
     }
 
-    // Hook RetouchAdvCharacter::say()
-    {
-        uintptr_t addr = base + Offsets::AdvCharSay;
-        Log("[*] Trying to hook RetouchAdvCharacter::say() at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&AdvCharSay_Hook, (void**)&g_origAdvCharSay) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] RetouchAdvCharacter::say() hooked\n");
+    static LRESULT CALLBACK InputWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+        if (msg == WM_INPUT) {
+            RAWINPUT input;
+            UINT size = sizeof(input);
+            if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) != (UINT)-1 &&
+                input.header.dwType == RIM_TYPEKEYBOARD && (input.data.keyboard.Flags & RI_KEY_BREAK)) {
+                OnKeyReleased(input.data.keyboard.VKey);
+            }
         }
+        return DefWindowProcW(hwnd, msg, wParam, lParam);
     }
 
-    // Hook RetouchPrintManager::printEx()
-    {
-        uintptr_t addr = base + Offsets::PrintEx;
-        Log("[*] Trying to hook RetouchPrintManager::printEx() at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&PrintEx_Hook, (void**)&g_origPrintEx) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] RetouchPrintManager::printEx() hooked\n");
+    static HWND CreateInputWindow() {
+        WNDCLASSW wc = {};
+        wc.lpfnWndProc = InputWindowProc;
+        wc.hInstance = GetModuleHandleW(nullptr);
+        wc.lpszClassName = kWindowClass;
+        RegisterClassW(&wc);
+
+        HWND window = CreateWindowExW(0, kWindowClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, wc.hInstance, nullptr);
+        if (!window) {
+            Log("[SERVICE] Cannot create input window - hotkeys disabled\n");
+            return nullptr;
+        }
+
+        RAWINPUTDEVICE keyboard = { 0x01, 0x06, RIDEV_INPUTSINK, window };  // Generic desktop, keyboard
+        if (!RegisterRawInputDevices(&keyboard, 1, sizeof(keyboard))) {
+            Log("[SERVICE] Raw keyboard input unavailable - hotkeys disabled\n");
         }
+        return window;
     }
 
-    // Hook SaveDataTitle() for LABEL translation
-    g_SaveDataIsValid = (Fn_SaveDataIsValid)(base + Offsets::SaveDataIsValid);
-    g_SaveDataGetItem = (Fn_SaveDataGetItem)(base + Offsets::SaveDataGetItem);
-    {
-        uintptr_t addr = base + Offsets::SaveDataTitle;
-        Log("[*] Trying to hook SaveDataTitle() at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&SaveDataTitle_Hook, (void**)&g_origSaveDataTitle) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] SaveDataTitle() hooked\n");
+    //-------------------------------------------------------------------------
+    // Debug console
+    //-------------------------------------------------------------------------
+    // The console only echoes input during ReadConsole, which would hold the
+    // thread until Enter, so read key events as they come and echo by hand
+    static HANDLE g_consoleIn = INVALID_HANDLE_VALUE;
+    static HANDLE g_consoleOut = INVALID_HANDLE_VALUE;
+    static std::wstring g_consoleLine;
+
+    static void Echo(const wchar_t* text, DWORD length) {
+        DWORD written;
+        WriteConsoleW(g_consoleOut, text, length, &written, nullptr);
+    }
+
+    static void SubmitConsoleLine() {
+        Echo(L"\r\n", 2);
+
+        std::string cmd;
+        int len = WideCharToMultiByte(CP_UTF8, 0, g_consoleLine.c_str(), (int)g_consoleLine.size(), nullptr, 0, nullptr, nullptr);
+        if (len > 0) {
+            cmd.resize(len);
+            WideCharToMultiByte(CP_UTF8, 0, g_consoleLine.c_str(), (int)g_consoleLine.size(), &cmd[0], len, nullptr, nullptr);
+        }
+        g_consoleLine.clear();
+
+        if (!cmd.empty()) {
+            ProcessDebugCommand(cmd);
         }
     }
 
-    // Hook RetouchSystem::prepareQuestion() for CHOICE translation
-    {
-        uintptr_t addr = base + Offsets::PrepareQuestion;
-        Log("[*] Trying to hook RetouchSystem::prepareQuestion() at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&PrepareQuestion_Hook, (void**)&g_origPrepareQuestion) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] RetouchSystem::prepareQuestion() hooked\n");
+    static void OnConsoleInput() {
+        INPUT_RECORD records[64];
+        DWORD count = 0;
+        if (!ReadConsoleInputW(g_consoleIn, records, 64, &count)) return;
+
+        for (DWORD i = 0; i < count; i++) {
+            if (records[i].EventType != KEY_EVENT || !records[i].Event.KeyEvent.bKeyDown) continue;
+
+            const KEY_EVENT_RECORD& key = records[i].Event.KeyEvent;
+            wchar_t c = key.uChar.UnicodeChar;
+            for (WORD repeat = 0; repeat < (std::max)(key.wRepeatCount, (WORD)1); repeat++) {
+                if (c == L'\r') {
+                    SubmitConsoleLine();
+                } else if (c == L'\b') {
+                    if (!g_consoleLine.empty()) {
+                        g_consoleLine.pop_back();
+                        Echo(L"\b \b", 3);
+                    }
+                } else if (c >= L' ') {
+                    g_consoleLine += c;
+                    Echo(&c, 1);
+                }
+            }
         }
     }
 
-    // Hook RetouchSystem::liteLoad() for scene tracking
-    {
-        uintptr_t addr = base + Offsets::LiteLoad;
-        Log("[*] Trying to hook RetouchSystem::liteLoad() at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&LiteLoad_Hook, (void**)&g_origLiteLoad) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] RetouchSystem::liteLoad() hooked - scene tracking active\n");
+    static void OpenConsole() {
+        g_consoleIn = CreateFileA("CONIN$", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_EXISTING, 0, nullptr);
+        g_consoleOut = CreateFileA("CONOUT$", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_EXISTING, 0, nullptr);
+        if (g_consoleIn == INVALID_HANDLE_VALUE || g_consoleOut == INVALID_HANDLE_VALUE) {
+            Log("[SERVICE] Cannot open the console for input\n");
+            return;
         }
+        Log("[*] Debug console ready. Type 'help' for commands.\n\n");
+    }
+
+    static void CloseConsole() {
+        if (g_consoleIn != INVALID_HANDLE_VALUE) CloseHandle(g_consoleIn);
+        if (g_consoleOut != INVALID_HANDLE_VALUE) CloseHandle(g_consoleOut);
+        g_consoleIn = INVALID_HANDLE_VALUE;
+        g_consoleOut = INVALID_HANDLE_VALUE;
+    }
+
+    //-------------------------------------------------------------------------
+    // Loop
+    //-------------------------------------------------------------------------
+    static DWORD WINAPI ThreadProc(LPVOID) {
+        HWND window = CreateInputWindow();
+        for (FileWatcher* watcher : g_watchers) watcher->Open();
+        if (Config::enableConsole) OpenConsole();
+        bool hasConsole = g_consoleIn != INVALID_HANDLE_VALUE && g_consoleOut != INVALID_HANDLE_VALUE;
+
+        ULONGLONG nextDiscord = GetTickCount64();
+        bool reclaimPending = false;
+        for (;;) {
+            // Handle list is rebuilt each pass - a watcher that failed drops out
+            HANDLE handles[5];
+            FileWatcher* owners[5] = {};
+            DWORD count = 0;
+            handles[count++] = g_stopEvent;
+            for (FileWatcher* watcher : g_watchers) {
+                if (!watcher->IsOpen()) continue;
+                owners[count] = watcher;
+                handles[count++] = watcher->Event();
+            }
+            DWORD consoleSlot = hasConsole ? count : MAXDWORD;
+            if (hasConsole) handles[count++] = g_consoleIn;
+            DWORD presenceSlot = g_presenceEvent ? count : MAXDWORD;
+            if (g_presenceEvent) handles[count++] = g_presenceEvent;
+
+            ULONGLONG now = GetTickCount64();
+            DWORD timeout = INFINITE;
+            for (FileWatcher* watcher : g_watchers) timeout = (std::min)(timeout, watcher->TimeUntilDue(now));
+            if (g_discordRunning) {
+                timeout = (std::min)(timeout, (nextDiscord > now) ? (DWORD)(nextDiscord - now) : 0);
+            }
+            if (reclaimPending) timeout = (std::min)(timeout, Constants::kReclaimRetryMs);
+
+            DWORD result = MsgWaitForMultipleObjectsEx(count, handles, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            if (result == WAIT_OBJECT_0) break;
+            if (result == WAIT_FAILED) {
+                Log("[SERVICE] Wait failed (%lu), stopping\n", GetLastError());
+                break;
+            }
+
+            now = GetTickCount64();
+            if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + count) {
+                DWORD slot = result - WAIT_OBJECT_0;
+                if (slot == consoleSlot) {
+                    OnConsoleInput();
+                } else if (slot == presenceSlot) {
+                    nextDiscord = now;  // New chapter posted - PumpDiscord decides if it can go out yet
+                } else {
+                    owners[slot]->OnSignaled(now);
+                }
+            } else if (result == WAIT_OBJECT_0 + count) {
+                MSG msg;
+                while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+                    DispatchMessageW(&msg);
+                }
+            }
+
+            for (FileWatcher* watcher : g_watchers) watcher->RunIfDue(now);
+            if (g_discordRunning && now >= nextDiscord) {
+                nextDiscord = PumpDiscord(now);
+            }
+
+            // Every reload runs on this thread, so any snapshot it retired is freed here
+            reclaimPending = g_translationDB.Reclaim() > 0;
+        }
+
+        for (FileWatcher* watcher : g_watchers) watcher->Close();
+        CloseConsole();
+        if (window) DestroyWindow(window);
+        UnregisterClassW(kWindowClass, GetModuleHandleW(nullptr));
+        return 0;
     }
 
-    // Hook internal codepage getter
-    {
-        uintptr_t addr = base + Offsets::GetCodePage;
-        Log("[*] Hooking codepage getter at 0x%p\n", (void*)addr);
-        if (MH_CreateHook((void*)addr, (void*)&GetCodePage_Hook, (void**)&g_origGetCodePage) == MH_OK) {
-            MH_EnableHook((void*)addr);
-            Log("[+] Codepage getter hooked -> 932 (Japanese)\n");
+    // Watchers must be configured first
+    static void Start() {
+        g_stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        g_thread = CreateThread(nullptr, 0, ThreadProc, nullptr, 0, nullptr);
+    }
+
+    static void Stop() {
+        if (g_stopEvent) SetEvent(g_stopEvent);
+        if (g_thread) {
+            // From DllMain the thread can't finish exiting until we return, so don't wait long
+            if (WaitForSingleObject(g_thread, 1000) == WAIT_OBJECT_0) {
+                CloseHandle(g_stopEvent);
+                g_stopEvent = nullptr;
+            }
+            CloseHandle(g_thread);
+            g_thread = nullptr;
         }
     }
+}
+
+//=============================================================================
+// Hook Installation
+//=============================================================================
+static bool InstallHooks(HMODULE hResident) {
+    uintptr_t base = (uintptr_t)hResident;
+    Log("[*] resident.dll base: 0x%p\n", (void*)base);
+
+    ForceCRTJapaneseCodepage();
 
-    // Get liteSetDebugMode function pointer
+    // Engine functions the hooks call
+    g_SaveDataIsValid = (Fn_SaveDataIsValid)(base + Offsets::SaveDataIsValid);
+    g_SaveDataGetItem = (Fn_SaveDataGetItem)(base + Offsets::SaveDataGetItem);
     g_liteSetDebugMode = (Fn_LiteSetDebugMode)(base + Offsets::LiteSetDebugMode);
     Log("[+] liteSetDebugMode at 0x%p\n", (void*)g_liteSetDebugMode);
 
+    Hooks::Install(Hooks::Group::Resident, base);
+
     Log("\n========================================\n");
     Log("Translation Hook Active!\n");
     Log("[*] Hotkeys: 0x%02X=Reload, 0x%02X=Stats, 0x%02X=Toggle Logging\n",
@@ -2193,62 +3094,53 @@ static bool InstallHooks(HMODULE hResident) {
 //=============================================================================
 // DialogBoxParamA Hook - Translate resource-based dialogs
 //=============================================================================
-typedef INT_PTR(WINAPI* Fn_DialogBoxParamA)(HINSTANCE, LPCSTR, HWND, DLGPROC, LPARAM);
-static Fn_DialogBoxParamA g_origDialogBoxParamA = nullptr;
+// Swap a control's SJIS text for its translation, if there is one
+static void TranslateWindowText(HWND hwnd) {
+    char text[256];
+    if (GetWindowTextA(hwnd, text, sizeof(text)) <= 0 || !text[0]) return;
+
+    TranslationDB::ReadGuard guard(g_translationDB);
+    const TranslationDB::Translation* translation = g_translationDB.FindUITranslation(text);
+    if (translation) {
+        SetWindowTextW(hwnd, Render::Wide(*translation));
+    }
+}
 
 // Callback to translate each child control in dialog
 static BOOL CALLBACK TranslateDialogChildProc(HWND hwnd, LPARAM lParam) {
-    char text[256];
-    if (GetWindowTextA(hwnd, text, sizeof(text)) > 0 && text[0]) {
-        // Try to find translation
-        const std::string* translation = g_translationDB.FindUITranslation(text);
-        if (translation) {
-            // Convert UTF-8 translation to Unicode and set
-            wchar_t wideText[256];
-            MultiByteToWideChar(CP_UTF8, 0, translation->c_str(), -1, wideText, 256);
-            SetWindowTextW(hwnd, wideText);
-        }
-    }
+    TranslateWindowText(hwnd);
     return TRUE; // Continue enumeration
 }
 
+// The CBT hook is registered once per thread and left in place (Windows drops
+// it with the thread); it only acts while a DialogBoxParamA is on the stack
+static thread_local HHOOK t_dialogCbtHook = nullptr;
+static thread_local int t_dialogDepth = 0;
+
+static LRESULT CALLBACK DialogCbtProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    if (nCode == HCBT_ACTIVATE && t_dialogDepth > 0) {
+        // Translate dialog title, then all child controls
+        HWND hwnd = (HWND)wParam;
+        TranslateWindowText(hwnd);
+        EnumChildWindows(hwnd, TranslateDialogChildProc, 0);
+    }
+    return CallNextHookEx(t_dialogCbtHook, nCode, wParam, lParam);
+}
+
 static INT_PTR WINAPI DialogBoxParamA_Hook(
     HINSTANCE hInstance, LPCSTR lpTemplateName, HWND hWndParent,
     DLGPROC lpDialogFunc, LPARAM dwInitParam)
 {
-    // Install a temporary CBT hook to translate dialog when it activates
-    static HHOOK s_cbtHook = nullptr;
-    
-    auto cbtProc = [](int nCode, WPARAM wParam, LPARAM lParam) -> LRESULT {
-        if (nCode == HCBT_ACTIVATE) {
-            HWND hwnd = (HWND)wParam;
-            
-            // Translate dialog title
-            char title[256];
-            if (GetWindowTextA(hwnd, title, sizeof(title)) > 0 && title[0]) {
-                const std::string* translation = g_translationDB.FindUITranslation(title);
-                if (translation) {
-                    wchar_t wideTitle[256];
-                    MultiByteToWideChar(CP_UTF8, 0, translation->c_str(), -1, wideTitle, 256);
-                    SetWindowTextW(hwnd, wideTitle);
-                }
-            }
-            
-            // Translate all child controls
-            EnumChildWindows(hwnd, TranslateDialogChildProc, 0);
-        }
-        return CallNextHookEx(s_cbtHook, nCode, wParam, lParam);
-    };
-    
-    s_cbtHook = SetWindowsHookExW(WH_CBT, cbtProc, nullptr, GetCurrentThreadId());
-    
-    INT_PTR result = g_origDialogBoxParamA(hInstance, lpTemplateName, hWndParent, lpDialogFunc, dwInitParam);
-    
-    if (s_cbtHook) {
-        UnhookWindowsHookEx(s_cbtHook);
-        s_cbtHook = nullptr;
+    WaitForTranslations();
+
+    if (!t_dialogCbtHook) {
+        t_dialogCbtHook = SetWindowsHookExW(WH_CBT, DialogCbtProc, nullptr, GetCurrentThreadId());
     }
-    
+
+    t_dialogDepth++;
+    INT_PTR result = g_origDialogBoxParamA(hInstance, lpTemplateName, hWndParent, lpDialogFunc, dwInitParam);
+    t_dialogDepth--;
+
     return result;
 }
 
@@ -2263,7 +3155,7 @@ static HMODULE WINAPI LoadLibraryExA_Hook(LPCSTR lpLibFileName, HANDLE hFile, DW
         if (_stricmp(name, "resident.dll") == 0) {
             Log("[*] resident.dll loaded\n");
             InstallHooks(result);
-            MH_DisableHook((void*)&LoadLibraryExA);
+            Hooks::Set("LoadLibraryExA", false);
         }
     }
 
@@ -2271,150 +3163,73 @@ static HMODULE WINAPI LoadLibraryExA_Hook(LPCSTR lpLibFileName, HANDLE hFile, DW
 }
 
 
-//=============================================================================
-// Codepage/Locale Hook Forward Declarations
-//=============================================================================
-typedef int(WINAPI* Fn_MultiByteToWideChar)(UINT, DWORD, LPCCH, int, LPWSTR, int);
-typedef int(WINAPI* Fn_WideCharToMultiByte)(UINT, DWORD, LPCWCH, int, LPSTR, int, LPCCH, LPBOOL);
-static Fn_MultiByteToWideChar g_origMultiByteToWideChar = nullptr;
-static Fn_WideCharToMultiByte g_origWideCharToMultiByte = nullptr;
-
-typedef HWND(WINAPI* Fn_CreateWindowExA)(DWORD, LPCSTR, LPCSTR, DWORD, int, int, int, int, HWND, HMENU, HINSTANCE, LPVOID);
-static Fn_CreateWindowExA g_origCreateWindowExA = nullptr;
-
-typedef BOOL(WINAPI* Fn_SetWindowTextA)(HWND, LPCSTR);
-static Fn_SetWindowTextA g_origSetWindowTextA = nullptr;
-
-static int WINAPI MultiByteToWideChar_Hook(UINT, DWORD, LPCCH, int, LPWSTR, int);
-static int WINAPI WideCharToMultiByte_Hook(UINT, DWORD, LPCWCH, int, LPSTR, int, LPCCH, LPBOOL);
-static HWND WINAPI CreateWindowExA_Hook(DWORD, LPCSTR, LPCSTR, DWORD, int, int, int, int, HWND, HMENU, HINSTANCE, LPVOID);
-static BOOL WINAPI SetWindowTextA_Hook(HWND, LPCSTR);
-
 //=============================================================================
 // Initialization
 //=============================================================================
-static bool Initialize() {
-    // Load config FIRST (before console init, so we know if console is enabled)
-    LoadConfig();
+// DllMain only does what must be in place before the game's next instruction:
+// the config, the locale hooks and the watch for resident.dll. Everything
+// else runs on DeferredInitThread once the loader lock is released.
+static HANDLE g_initThread = nullptr;
+static int g_earlyHooks = 0;  // Hooked before logging was up; reported by the init thread
 
-    if (Config::enableConsole) {
-        InitConsole();
+static void InstallDeferredHooks() {
+    if (Config::enableAssetRedirect) {
+        // Create assets directory if needed
+        CreateDirectoryA(".\\tl", nullptr);
+        CreateDirectoryA(Config::tlAssetsPath, nullptr);
+        AssetRedirect::Rescan();
+        AssetRedirect::StartTranscoder();
+        Log("[+] Asset redirection from %s\n", Config::tlAssetsPath);
+    }
 
-        // Enable console input
-        FILE* stdinFile;
-        freopen_s(&stdinFile, "CONIN$", "r", stdin);
+    Hooks::Install(Hooks::Group::Deferred);
+}
 
-        // Start input thread
-        CreateThread(nullptr, 0, ConsoleInputThread, nullptr, 0, nullptr);
-    }
+static DWORD WINAPI DeferredInitThread(LPVOID) {
+    InitLogging();
 
     const char* base_title = Config::windowTitle[0] ? Config::windowTitle : "よついろ★パッショナート！";
 
     Log("==================================================\n");
     Log("%s - Translation Hook\n", base_title);
     Log("==================================================\n\n");
-
-    // Load DiscordRPC
-    if (Config::enableDiscordPresence) {
-        InitDiscordRPC();
-        Log("[Discord] Rich Presence enabled (can disable in ini: EnableDiscordPresence=false)\n");
-    } else {
-        Log("[Discord] Rich Presence disabled in config\n");
-    }
-
-    // Load translations using config paths
-    g_translationDB.Load(Config::translationFile, Config::namesFile);
-    LoadCharIdTable(Config::charIdFile);
-
-    if (MH_Initialize() != MH_OK) {
-        Log("[!] MinHook init failed\n");
-        return false;
-    }
-
-    //=========================================================================
-    // Locale/Codepage Hooks - Fix Japanese window titles on non-JP systems
-    //=========================================================================
-    if (MH_CreateHookApi(L"kernelbase", "MultiByteToWideChar",
-        (void*)&MultiByteToWideChar_Hook, (void**)&g_origMultiByteToWideChar) == MH_OK) {
-        Log("[LOCALE] MultiByteToWideChar hooked (CP_ACP -> CP932)\n");
-    }
-    if (MH_CreateHookApi(L"kernelbase", "WideCharToMultiByte",
-        (void*)&WideCharToMultiByte_Hook, (void**)&g_origWideCharToMultiByte) == MH_OK) {
-        Log("[LOCALE] WideCharToMultiByte hooked (CP_ACP -> CP932)\n");
-    }
-    if (MH_CreateHookApi(L"user32", "CreateWindowExA",
-        (void*)&CreateWindowExA_Hook, (void**)&g_origCreateWindowExA) == MH_OK) {
-        Log("[LOCALE] CreateWindowExA hooked (-> Unicode + DefWindowProcW)\n");
-    }
-    if (MH_CreateHookApi(L"user32", "SetWindowTextA",
-        (void*)&SetWindowTextA_Hook, (void**)&g_origSetWindowTextA) == MH_OK) {
-        Log("[LOCALE] SetWindowTextA hooked (-> DefWindowProcW)\n");
-    }
-    if (MH_CreateHookApi(L"user32", "DialogBoxParamA",
-        (void*)&DialogBoxParamA_Hook, (void**)&g_origDialogBoxParamA) == MH_OK) {
-        Log("[DIALOG] DialogBoxParamA hooked (for UI translation)\n");
-    }
-
-    // Hook GetACP/GetOEMCP
-    if (MH_CreateHookApi(L"kernel32", "GetACP",
-        (void*)&GetACP_Hook, (void**)&g_origGetACP) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[LOCALE] GetACP hooked -> 932 (Japanese)\n");
-    }
-
-    if (MH_CreateHookApi(L"kernel32", "GetOEMCP",
-        (void*)&GetOEMCP_Hook, (void**)&g_origGetOEMCP) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[LOCALE] GetOEMCP hooked -> 932 (Japanese)\n");
-    }
-
-    // Hook CharPrevA/CharNextA
-    if (MH_CreateHookApi(L"user32", "CharPrevA",
-        (void*)&CharPrevA_Hook, (void**)&g_origCharPrevA) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[LOCALE] CharPrevA hooked -> SJIS\n");
-    }
-
-    if (MH_CreateHookApi(L"user32", "CharNextA",
-        (void*)&CharNextA_Hook, (void**)&g_origCharNextA) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[LOCALE] CharNextA hooked -> SJIS\n");
-    }
-
-    // Hook OutputDebugStringA to capture game debug output
-    if (MH_CreateHookApi(L"kernel32", "OutputDebugStringA",
-        (void*)&OutputDebugStringA_Hook, (void**)&g_origOutputDebugStringA) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[+] OutputDebugStringA hooked - game debug → console\n");
-    }
-
-    // Hook GetGlyphOutlineA
-    if (MH_CreateHookApi(L"gdi32", "GetGlyphOutlineA",
-        (void*)&GetGlyphOutlineA_Hook, (void**)&g_origGetGlyphOutlineA) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[+] GetGlyphOutlineA hooked\n");
-    }
-
-    // Hook CreateFontIndirect
-    if (MH_CreateHookApi(L"gdi32", "CreateFontIndirectA",
-        (void*)&CreateFontIndirectA_Hook,
-        (void**)&g_origCreateFontIndirectA) == MH_OK) {
-        MH_EnableHook(MH_ALL_HOOKS);
-        Log("[+] Font hook installed\n");
-    }
-
-    // Hook CreateFileA for asset redirection
-    if (Config::enableAssetRedirect) {
-        // Create assets directory if needed
-        CreateDirectoryA(".\\tl", nullptr);
-        CreateDirectoryA(Config::tlAssetsPath, nullptr);
-
-        if (MH_CreateHookApi(L"kernel32", "CreateFileA",
-            (void*)&CreateFileA_Hook, (void**)&g_origCreateFileA) == MH_OK) {
-            MH_EnableHook(MH_ALL_HOOKS);
-            Log("[+] Asset redirection hooked (%s)\n", Config::tlAssetsPath);
+    Log("[LOCALE] %d codepage/window hooks installed at load\n", g_earlyHooks);
+
+    // Cheap, and the game may already be creating fonts - so before the slow part
+    InstallDeferredHooks();
+
+    // Independent of each other: Discord's handshake, the TSV parse (itself
+    // parallel), the char table and the font prewarm. Hooks only wait for the
+    // middle two, so whichever of those finishes last lets them go.
+    g_translationDB.SetChapterListener(UpdateChapterPresence);
+    MissDump::Start();
+    std::atomic<int> textTasksLeft{2};
+    auto textTaskDone = [&textTasksLeft] {
+        if (textTasksLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) SignalTranslationsReady();
+    };
+    ParallelFor(4, [&](size_t task) {
+        switch (task) {
+        case 0:
+            if (Config::enableDiscordPresence) {
+                InitDiscordRPC();
+                Log("[Discord] Rich Presence enabled (can disable in ini: EnableDiscordPresence=false)\n");
+            } else {
+                Log("[Discord] Rich Presence disabled in config\n");
+            }
+            break;
+        case 1:
+            g_translationDB.Load(Config::translationFile, Config::namesFile);
+            textTaskDone();
+            break;
+        case 2:
+            LoadCharIdTable(Config::charIdFile);
+            textTaskDone();
+            break;
+        case 3:
+            FontCache::Prewarm();
+            break;
         }
-    }
+    });
 
     // Start file watcher
     std::string watchDir = ".\\tl"; // Default
@@ -2424,53 +3239,86 @@ static bool Initialize() {
         watchDir = transFile.substr(0, lastSlash);
     }
 
-    g_fileWatcher.Start(watchDir.c_str(), { 
+    g_fileWatcher.Configure(watchDir.c_str(), { 
         AssetRedirect::GetFileName(Config::translationFile), 
         AssetRedirect::GetFileName(Config::namesFile) 
     }, []() {
-        g_stringPool.Clear();
         g_translationDB.Reload();
         MessageBeep(MB_OK);
     });
 
-    // Start hotkey thread
-    g_hotkeyThread = CreateThread(nullptr, 0, HotkeyThreadProc, nullptr, 0, nullptr);
+    if (Config::enableAssetRedirect) {
+        g_assetWatcher.Configure(Config::tlAssetsPath, {}, []() {
+            AssetRedirect::Rescan();
+        }, true);
+    }
+
+    // Hotkeys, both watchers, console input and Discord callbacks
+    Service::Start();
+
+    // Decrypts each scene's .rld so lines can be matched by script position
+    SceneLoader::Start();
+    return 0;
+}
+
+static bool Initialize() {
+    // The console and log file open on the init thread; hold DllMain's lines until then
+    AsyncLog::Buffer();
+
+    // INI reads only - the locale hooks below need the window title
+    LoadConfig();
+    Perf::Init();
+
+    g_translationsReadyEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+    if (MH_Initialize() != MH_OK) {
+        SignalTranslationsReady();  // Nothing will load; never hold a hook up
+        return false;
+    }
 
+    // Locale/Codepage Hooks - Fix Japanese window titles on non-JP systems
+    g_earlyHooks = Hooks::Install(Hooks::Group::Locale);
+
+    bool ok;
     HMODULE hResident = GetModuleHandleA("resident.dll");
     if (hResident) {
-        return InstallHooks(hResident);
+        ok = InstallHooks(hResident);
+    } else {
+        ok = Hooks::Install(Hooks::Group::Loader) > 0;
     }
 
-    if (MH_CreateHookApi(L"kernel32", "LoadLibraryExA",
-        (void*)&LoadLibraryExA_Hook, (void**)&g_origLoadLibraryExA) == MH_OK) {
-        MH_EnableHook((void*)&LoadLibraryExA);
-        Log("[*] Waiting for resident.dll...\n");
-        return true;
+    // Starts running once DllMain returns
+    g_initThread = CreateThread(nullptr, 0, DeferredInitThread, nullptr, 0, nullptr);
+    if (!g_initThread) {
+        DeferredInitThread(nullptr);
     }
-
-    return false;
+    return ok;
 }
 
 static void Shutdown() {
-    g_running = false;
-    g_fileWatcher.Stop();
+    // An unload mid-startup: give the init thread a moment, it may hold MinHook
+    if (g_initThread) {
+        WaitForSingleObject(g_initThread, 1000);
+        CloseHandle(g_initThread);
+        g_initThread = nullptr;
+    }
+
+    Service::Stop();
+    AssetRedirect::StopTranscoder();
+    SceneLoader::Stop();
 
     if (Config::enableDiscordPresence) {
         ShutdownDiscordRPC();
     }
 
-    if (g_hotkeyThread) {
-        WaitForSingleObject(g_hotkeyThread, 1000);
-        CloseHandle(g_hotkeyThread);
-    }
-
     Log("\n[*] Shutting down...\n");
     MH_Uninitialize();
+    MissDump::Stop();
 
-    if (g_logFile) {
-        fclose(g_logFile);
-        FreeConsole();
-    }
+    AsyncLog::Stop();
+    bool hadConsole = g_logFile != nullptr;
+    AsyncLog::CloseSinks();
+    if (hadConsole) FreeConsole();
 }
 
 //=============================================================================
@@ -2504,6 +3352,20 @@ static int WINAPI WideCharToMultiByte_Hook(
 //=============================================================================
 static HWND g_mainGameWindow = nullptr;
 
+// Config::windowTitle as UTF-16, converted on first use; nullptr = keep the game's
+static const wchar_t* WideWindowTitle() {
+    static const std::wstring s_title = [] {
+        std::wstring title;
+        int length = MultiByteToWideChar(CP_UTF8, 0, Config::windowTitle, -1, nullptr, 0);
+        if (length > 1) {
+            title.resize(length - 1);
+            MultiByteToWideChar(CP_UTF8, 0, Config::windowTitle, -1, &title[0], length);
+        }
+        return title;
+    }();
+    return s_title.empty() ? nullptr : s_title.c_str();
+}
+
 static HWND WINAPI CreateWindowExA_Hook(
     DWORD dwExStyle, LPCSTR lpClassName, LPCSTR lpWindowName, DWORD dwStyle,
     int x, int y, int nWidth, int nHeight,
@@ -2529,22 +3391,22 @@ static HWND WINAPI CreateWindowExA_Hook(
     // Only apply custom title to main window (top-level, has title, no parent)
     bool isMainWindow = (hWndParent == nullptr) && lpWindowName && lpWindowName[0];
     
-    if (isMainWindow && Config::windowTitle[0] != '\0') {
+    TranslationDB::ReadGuard guard(g_translationDB);  // Keeps a cached translation alive until it is set
+    if (isMainWindow && WideWindowTitle()) {
         // Custom window title from config
-        MultiByteToWideChar(CP_UTF8, 0, Config::windowTitle, -1, wideTitle, 512);
-        pWideTitle = wideTitle;
+        pWideTitle = WideWindowTitle();
     } 
     else if (lpWindowName && lpWindowName[0]) {
         // Try to find UI translation (for dialogs, buttons, etc.)
-        const std::string* uiTranslation = g_translationDB.FindUITranslation(lpWindowName);
+        const TranslationDB::Translation* uiTranslation = g_translationDB.FindUITranslation(lpWindowName);
         if (uiTranslation) {
-            // Found translation - convert UTF-8 to Unicode
-            MultiByteToWideChar(CP_UTF8, 0, uiTranslation->c_str(), -1, wideTitle, 512);
+            // Found translation - already UTF-16 after the first time
+            pWideTitle = Render::Wide(*uiTranslation);
         } else {
             // No translation - just convert SJIS to Unicode
             g_origMultiByteToWideChar(932, 0, lpWindowName, -1, wideTitle, 512);
+            pWideTitle = wideTitle;
         }
-        pWideTitle = wideTitle;
     }
 
     // Create window using Unicode API
@@ -2572,10 +3434,8 @@ static HWND WINAPI CreateWindowExA_Hook(
 static BOOL WINAPI SetWindowTextA_Hook(HWND hWnd, LPCSTR lpString)
 {
     // Only override main game window with custom title (not dialogs)
-    if (Config::windowTitle[0] != '\0' && hWnd == g_mainGameWindow) {
-        wchar_t wideTitle[256];
-        MultiByteToWideChar(CP_UTF8, 0, Config::windowTitle, -1, wideTitle, 256);
-        DefWindowProcW(hWnd, WM_SETTEXT, 0, (LPARAM)wideTitle);
+    if (hWnd == g_mainGameWindow && WideWindowTitle()) {
+        DefWindowProcW(hWnd, WM_SETTEXT, 0, (LPARAM)WideWindowTitle());
         return TRUE;
     }
 
@@ -199,8 +199,10 @@ static const char* g_exportNames[] = {
     "wod32Message",             // 192
 };
 
-static FARPROC g_procs[_countof(g_exportNames)] = {};
+FARPROC g_procs[_countof(g_exportNames)] = {};  // C linkage from proxy.h
 
+// Bound once from DllMain, so the stubs need no checks: an export the real
+// winmm lacks stays null and faults at the call, as the lazy lookup did
 BOOL proxy_init() {
     if (g_hReal) return TRUE;
 
@@ -208,7 +210,12 @@ BOOL proxy_init() {
     GetSystemDirectoryA(path, MAX_PATH);
     strcat_s(path, "\\winmm.dll");
     g_hReal = LoadLibraryA(path);
-    return g_hReal != nullptr;
+    if (!g_hReal) return FALSE;
+
+    for (size_t i = 0; i < _countof(g_exportNames); i++) {
+        g_procs[i] = GetProcAddress(g_hReal, g_exportNames[i]);
+    }
+    return TRUE;
 }
 
 void proxy_free() {
@@ -217,11 +224,3 @@ void proxy_free() {
         g_hReal = nullptr;
     }
 }
-
-FARPROC __stdcall resolve_export(size_t index) {
-    if (index >= _countof(g_exportNames)) return nullptr;
-    if (g_procs[index]) return g_procs[index];
-    if (!g_hReal && !proxy_init()) return nullptr;
-    g_procs[index] = GetProcAddress(g_hReal, g_exportNames[index]);
-    return g_procs[index];
-}
@@ -2,7 +2,9 @@
 #include <Windows.h>
 
 extern "C" {
-    BOOL proxy_init();
+    BOOL proxy_init();  // Loads the real winmm and binds every export - before anything can call one
     void proxy_free();
-    FARPROC __stdcall resolve_export(size_t index);
+
+    // Read by the stubs in proxy_exports.asm: jmp [g_procs + index*4]
+    extern FARPROC g_procs[];
 }
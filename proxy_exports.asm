@@ -1,15 +1,14 @@
 .model flat
 .code
 
-extern _resolve_export@4:proc
+extern _g_procs:dword
 
-; Macro to generate export stubs
+; Macro to generate export stubs - g_procs is filled by proxy_init before
+; any caller can get here, so each is a single indirect jump
 PROXY_EXPORT macro name, index
 public _&name
 _&name proc
-    push index
-    call _resolve_export@4
-    jmp eax
+    jmp dword ptr [_g_procs + index * 4]
 _&name endp
 endm
 
@@ -0,0 +1,645 @@
+#include "text.h"
+#include <cstring>
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//=============================================================================
+// Encoding Detection & Conversion
+//=============================================================================
+namespace Encoding {
+    //-------------------------------------------------------------------------
+    // CP932 tables
+    //-------------------------------------------------------------------------
+    // Built once from the system code page so output matches what the Win32
+    // converters produced (including best-fit), then every conversion is a
+    // table lookup with no API calls and no intermediate UTF-16 string.
+    namespace {
+        constexpr uint16_t kDefaultWide = 0x30FB;  // CP932's default Unicode char
+        constexpr int kLeadCount = 60;             // 0x81-0x9F, 0xE0-0xFC
+
+        inline bool IsLead(unsigned char c) {
+            return (c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC);
+        }
+
+        inline int LeadIndex(unsigned char c) {
+            return (c <= 0x9F) ? c - 0x81 : c - 0xE0 + 31;
+        }
+
+        struct Cp932Tables {
+            uint16_t single[256];              // Non-lead bytes (and lone leads) -> UTF-16
+            uint16_t pair[kLeadCount][256];    // Lead + trail -> UTF-16, 0 = not a valid pair
+            uint16_t reverse[0x10000];         // UTF-16 -> SJIS, two-byte codes have the lead in the high byte
+        };
+
+        void BuildForward(Cp932Tables& tables) {
+            for (int b = 0; b < 256; b++) {
+                char in = (char)b;
+                wchar_t out = 0;
+                tables.single[b] = (MultiByteToWideChar(932, 0, &in, 1, &out, 1) == 1 && out)
+                    ? (uint16_t)out : kDefaultWide;
+            }
+            tables.single[0] = 0;
+
+            memset(tables.pair, 0, sizeof(tables.pair));
+            for (int lead = 0x81; lead <= 0xFC; lead++) {
+                if (!IsLead((unsigned char)lead)) continue;
+                for (int trail = 0x40; trail <= 0xFC; trail++) {
+                    char in[2] = { (char)lead, (char)trail };
+                    wchar_t out = 0;
+                    if (MultiByteToWideChar(932, MB_ERR_INVALID_CHARS, in, 2, &out, 1) == 1) {
+                        tables.pair[LeadIndex((unsigned char)lead)][trail] = (uint16_t)out;
+                    }
+                }
+            }
+        }
+
+        // Store one WideCharToMultiByte result; returns bytes consumed, 0 if malformed
+        size_t StoreReverse(Cp932Tables& tables, wchar_t wide, const unsigned char* sjis, size_t available) {
+            if (available >= 2 && IsLead(sjis[0])) {
+                tables.reverse[wide] = (uint16_t)((sjis[0] << 8) | sjis[1]);
+                return 2;
+            }
+            if (available >= 1 && !IsLead(sjis[0])) {
+                tables.reverse[wide] = sjis[0];
+                return 1;
+            }
+            return 0;
+        }
+
+        void BuildReverse(Cp932Tables& tables) {
+            constexpr int kBatch = 0x800;
+            wchar_t wide[kBatch];
+            unsigned char sjis[kBatch * 2];
+
+            for (int i = 0; i < 0x10000; i++) tables.reverse[i] = '?';
+            tables.reverse[0] = 0;
+
+            // Convert whole batches, one API call each; every char maps to exactly one
+            // SJIS char in practice, but fall back to per-char calls if that ever fails
+            for (int base = 0; base < 0x10000; base += kBatch) {
+                if (base >= 0xD800 && base < 0xE000) continue;  // Surrogates stay '?'
+
+                int count = 0;
+                for (int c = (base == 0) ? 1 : base; c < base + kBatch; c++) wide[count++] = (wchar_t)c;
+
+                int written = WideCharToMultiByte(932, 0, wide, count, (char*)sjis, sizeof(sjis), nullptr, nullptr);
+                size_t offset = 0;
+                int mapped = 0;
+                while (written > 0 && mapped < count && offset < (size_t)written) {
+                    size_t used = StoreReverse(tables, wide[mapped], sjis + offset, written - offset);
+                    if (!used) break;
+                    offset += used;
+                    mapped++;
+                }
+                if (mapped == count && offset == (size_t)written) continue;
+
+                for (int j = 0; j < count; j++) {
+                    int n = WideCharToMultiByte(932, 0, &wide[j], 1, (char*)sjis, 2, nullptr, nullptr);
+                    if (n <= 0 || !StoreReverse(tables, wide[j], sjis, n)) tables.reverse[wide[j]] = '?';
+                }
+            }
+        }
+
+        const Cp932Tables& Tables() {
+            static const std::unique_ptr<Cp932Tables> s_tables = [] {
+                std::unique_ptr<Cp932Tables> tables(new Cp932Tables);
+                BuildForward(*tables);
+                BuildReverse(*tables);
+                return tables;
+            }();
+            return *s_tables;
+        }
+
+        //---------------------------------------------------------------------
+        // ASCII fast path
+        //---------------------------------------------------------------------
+        inline unsigned CountTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return (unsigned)index;
+#else
+            return (unsigned)__builtin_ctz(mask);
+#endif
+        }
+
+        // Copy the leading ASCII run of src to dst, 16 bytes at a time; returns its length.
+        // Whole blocks are stored even when they end in non-ASCII, so dst needs 16 bytes
+        // of room whenever 16 bytes of src remain - both converters' size bounds give that.
+        size_t CopyAscii(const unsigned char* src, size_t length, char* dst) {
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+                _mm_storeu_si128((__m128i*)(dst + i), block);
+                unsigned mask = (unsigned)_mm_movemask_epi8(block);
+                if (mask) return i + CountTrailingZeros(mask);
+            }
+            while (i < length && src[i] < 0x80) {
+                dst[i] = (char)src[i];
+                i++;
+            }
+            return i;
+        }
+
+        inline size_t EncodeUtf8(uint16_t wide, char* dst) {
+            if (wide < 0x80) {
+                dst[0] = (char)wide;
+                return 1;
+            }
+            if (wide < 0x800) {
+                dst[0] = (char)(0xC0 | (wide >> 6));
+                dst[1] = (char)(0x80 | (wide & 0x3F));
+                return 2;
+            }
+            dst[0] = (char)(0xE0 | (wide >> 12));
+            dst[1] = (char)(0x80 | ((wide >> 6) & 0x3F));
+            dst[2] = (char)(0x80 | (wide & 0x3F));
+            return 3;
+        }
+
+        inline bool IsContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+        // Length of the leading ASCII run, 16 bytes per step
+        size_t AsciiPrefix(const unsigned char* src, size_t length) {
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                unsigned mask = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(src + i)));
+                if (mask) return i + CountTrailingZeros(mask);
+            }
+            while (i < length && src[i] < 0x80) i++;
+            return i;
+        }
+
+        // Length of the well-formed UTF-8 sequence at src, 0 if there isn't one
+        size_t Utf8SequenceLength(const unsigned char* src, size_t available) {
+            unsigned char c = src[0];
+            size_t length = (c >= 0xC2 && c <= 0xDF) ? 2 : (c >= 0xE0 && c <= 0xEF) ? 3 :
+                (c >= 0xF0 && c <= 0xF4) ? 4 : 0;
+            if (length == 0 || available < length) return 0;
+            for (size_t i = 1; i < length; i++) {
+                if (!IsContinuation(src[i])) return 0;
+            }
+            if (c == 0xE0 && src[1] < 0xA0) return 0;   // Overlong
+            if (c == 0xED && src[1] >= 0xA0) return 0;  // Surrogate
+            if (c == 0xF0 && src[1] < 0x90) return 0;   // Overlong
+            if (c == 0xF4 && src[1] >= 0x90) return 0;  // Past U+10FFFF
+            return length;
+        }
+
+        // Decode one non-ASCII UTF-8 sequence; returns bytes consumed and sets wide
+        // to 0 for anything outside the BMP or malformed (both become '?')
+        inline size_t DecodeUtf8(const unsigned char* src, size_t available, uint16_t& wide) {
+            unsigned char c = src[0];
+            wide = 0;
+            if (c >= 0xC2 && c <= 0xDF) {
+                if (available < 2 || !IsContinuation(src[1])) return 1;
+                wide = (uint16_t)(((c & 0x1F) << 6) | (src[1] & 0x3F));
+                return 2;
+            }
+            if (c >= 0xE0 && c <= 0xEF) {
+                if (available < 3 || !IsContinuation(src[1]) || !IsContinuation(src[2])) return 1;
+                if ((c == 0xE0 && src[1] < 0xA0) || (c == 0xED && src[1] >= 0xA0)) return 3;  // Overlong / surrogate
+                wide = (uint16_t)(((c & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F));
+                return 3;
+            }
+            if (c >= 0xF0 && c <= 0xF4) {
+                if (available < 4 || !IsContinuation(src[1]) || !IsContinuation(src[2]) ||
+                    !IsContinuation(src[3])) return 1;
+                return 4;
+            }
+            return 1;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Detection
+    //-------------------------------------------------------------------------
+    // Walks the whole buffer: anything that is entirely well-formed UTF-8 is
+    // UTF-8, otherwise the byte scores decide as before
+    Type Detect(const char* data, size_t size) {
+        if (size == 0) return Type::Unknown;
+
+        const unsigned char* src = (const unsigned char*)data;
+        if (size >= 3 && src[0] == 0xEF && src[1] == 0xBB && src[2] == 0xBF) {
+            return Type::UTF8_BOM;
+        }
+
+        size_t utf8Score = 0;
+        size_t sjisScore = 0;
+        size_t utf8Errors = 0;
+
+        for (size_t i = 0; i < size; ) {
+            if (src[i] < 0x80) {
+                i += AsciiPrefix(src + i, size - i);
+                continue;
+            }
+
+            size_t length = Utf8SequenceLength(src + i, size - i);
+            if (length) {
+                utf8Score += length;
+                i += length;
+                continue;
+            }
+
+            utf8Errors++;
+            if (IsLead(src[i]) && i + 1 < size) {
+                unsigned char trail = src[i + 1];
+                if ((trail >= 0x40 && trail <= 0x7E) || (trail >= 0x80 && trail <= 0xFC)) {
+                    sjisScore += 2;
+                    i += 2;
+                    continue;
+                }
+            }
+            i++;
+        }
+
+        if (utf8Errors == 0) return Type::UTF8;  // Includes ASCII-only
+        if (utf8Score > sjisScore * 2) return Type::UTF8;
+        if (sjisScore > 0) return Type::ShiftJIS;
+        return Type::UTF8;
+    }
+
+    //-------------------------------------------------------------------------
+    // Conversion
+    //-------------------------------------------------------------------------
+    size_t SjisToUtf8(const char* sjis, size_t length, char* dst) {
+        const Cp932Tables& tables = Tables();
+        const unsigned char* src = (const unsigned char*)sjis;
+        size_t in = 0, out = 0;
+
+        while (in < length) {
+            unsigned char c = src[in];
+            if (c < 0x80) {
+                size_t run = CopyAscii(src + in, length - in, dst + out);
+                in += run;
+                out += run;
+                continue;
+            }
+
+            uint16_t wide = 0;
+            if (IsLead(c) && in + 1 < length) wide = tables.pair[LeadIndex(c)][src[in + 1]];
+            if (wide) {
+                in += 2;
+            } else {
+                wide = tables.single[c];
+                in++;
+            }
+            out += EncodeUtf8(wide, dst + out);
+        }
+        return out;
+    }
+
+    size_t Utf8ToSjis(const char* utf8, size_t length, char* dst) {
+        const Cp932Tables& tables = Tables();
+        const unsigned char* src = (const unsigned char*)utf8;
+        size_t in = 0, out = 0;
+
+        while (in < length) {
+            if (src[in] < 0x80) {
+                size_t run = CopyAscii(src + in, length - in, dst + out);
+                in += run;
+                out += run;
+                continue;
+            }
+
+            uint16_t wide;
+            in += DecodeUtf8(src + in, length - in, wide);
+            uint16_t code = wide ? tables.reverse[wide] : (uint16_t)'?';
+            if (code > 0xFF) dst[out++] = (char)(code >> 8);
+            dst[out++] = (char)code;
+        }
+        return out;
+    }
+
+    void AppendSjisToUtf8(std::string& out, std::string_view sjis) {
+        size_t start = out.size();
+        out.resize(start + MaxUtf8Size(sjis.size()));
+        out.resize(start + SjisToUtf8(sjis.data(), sjis.size(), &out[start]));
+    }
+
+    void AppendUtf8ToSjis(std::string& out, std::string_view utf8) {
+        size_t start = out.size();
+        out.resize(start + MaxSjisSize(utf8.size()));
+        out.resize(start + Utf8ToSjis(utf8.data(), utf8.size(), &out[start]));
+    }
+
+    // Shift-JIS -> UTF-8
+    std::string SjisToUtf8(const char* sjis) {
+        std::string utf8;
+        if (sjis && *sjis) AppendSjisToUtf8(utf8, sjis);
+        return utf8;
+    }
+
+    // UTF-8 -> Shift-JIS
+    std::string Utf8ToSjis(const char* utf8) {
+        std::string sjis;
+        if (utf8 && *utf8) AppendUtf8ToSjis(sjis, utf8);
+        return sjis;
+    }
+
+    // Convert any encoding to UTF-8
+    std::string ToUtf8(const std::string& data, Type encoding) {
+        switch (encoding) {
+        case Type::UTF8_BOM:
+            return data.size() >= 3 ? data.substr(3) : data;
+        case Type::UTF8:
+            return data;
+        case Type::ShiftJIS:
+            return SjisToUtf8(data.c_str());
+        default:
+            return data;
+        }
+    }
+}
+
+//=============================================================================
+// Shitty Text Fix
+//=============================================================================
+namespace TextFix {
+    // Replace UTF-8 chars that don't exist in SJIS with ones that do
+    std::string NormalizeUtf8(std::string_view utf8) {
+        std::string result;
+        result.reserve(utf8.size());
+
+        for (size_t i = 0; i < utf8.size(); ) {
+            // Check for em-dash "?" (UTF-8: E2 80 94)
+            if (i + 2 < utf8.size() &&
+                (unsigned char)utf8[i] == 0xE2 &&
+                (unsigned char)utf8[i+1] == 0x80 &&
+                (unsigned char)utf8[i+2] == 0x94) {
+                // Replace with horizontal bar "―" (UTF-8: E2 80 95) - exists in SJIS
+                result += "\xE2\x80\x95";
+                i += 3;
+                continue;
+            }
+
+            // Check for en-dash "?" (UTF-8: E2 80 93)
+            if (i + 2 < utf8.size() &&
+                (unsigned char)utf8[i] == 0xE2 &&
+                (unsigned char)utf8[i+1] == 0x80 &&
+                (unsigned char)utf8[i+2] == 0x93) {
+                result += "\xE2\x80\x95";
+                i += 3;
+                continue;
+            }
+
+            // Check for curly quotes and replace with straight
+            if (i + 2 < utf8.size() &&
+                (unsigned char)utf8[i] == 0xE2 &&
+                (unsigned char)utf8[i+1] == 0x80) {
+                unsigned char c3 = (unsigned char)utf8[i+2];
+                if (c3 == 0x98 || c3 == 0x99) {  // ' or '
+                    result += "'";
+                    i += 3;
+                    continue;
+                }
+                if (c3 == 0x9C || c3 == 0x9D) {  // " or "
+                    result += "\"";
+                    i += 3;
+                    continue;
+                }
+            }
+
+            result += utf8[i];
+            i++;
+        }
+
+        return result;
+    }
+}
+
+//=============================================================================
+// Word Wrapping
+//=============================================================================
+namespace WordWrap {
+    bool IsSjisLead(unsigned char c) {
+        return (c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC);
+    }
+
+    std::string Wrap(const std::string& text, int maxWidth) {
+        if (text.empty() || maxWidth <= 0) return text;
+
+        std::string result;
+        result.reserve(text.size() + 64);
+
+        int lineLen = 0;
+        size_t lineStart = 0;
+        size_t lastSpace = std::string::npos;
+
+        for (size_t i = 0; i < text.size(); ) {
+            unsigned char c = (unsigned char)text[i];
+
+            // Existing newline - reset
+            if (c == '\n') {
+                result += c;
+                lineLen = 0;
+                lineStart = result.size();
+                lastSpace = std::string::npos;
+                i++;
+                continue;
+            }
+
+            // SJIS double-byte (Japanese) - don't count for word wrap
+            if (IsSjisLead(c) && i + 1 < text.size()) {
+                result += text[i];
+                result += text[i + 1];
+                lineLen += 2;
+                i += 2;
+                continue;
+            }
+
+            // Remember last space position for word wrap
+            if (c == ' ') {
+                lastSpace = result.size();
+            }
+
+            result += c;
+            lineLen++;
+
+            // Need to wrap?
+            if (lineLen >= maxWidth) {
+                if (lastSpace != std::string::npos && lastSpace > lineStart) {
+                    // Replace space with newline
+                    result[lastSpace] = '\n';
+                    lineLen = (int)(result.size() - lastSpace - 1);
+                    lineStart = lastSpace + 1;
+                    lastSpace = std::string::npos;
+                }
+                // else: no good break point, let it overflow (game will handle)
+            }
+
+            i++;
+        }
+
+        return result;
+    }
+}
+
+//=============================================================================
+// Text Files
+//=============================================================================
+bool TextFile::Open(const char* path) {
+    Close();
+
+    // Share everything so an editor can still save while we read
+    m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart > 0x7FFFFFFF) {
+        Close();
+        return false;
+    }
+
+    // An empty file can't be mapped, and needs nothing from the mapping anyway
+    if (size.QuadPart > 0) {
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping) m_view = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_view) {
+            Close();
+            return false;
+        }
+    }
+
+    std::string_view raw(m_view ? m_view : "", (size_t)size.QuadPart);
+    m_encoding = Encoding::Detect(raw.data(), raw.size());
+    switch (m_encoding) {
+    case Encoding::Type::UTF8_BOM:
+        m_text = raw.substr(3);
+        break;
+    case Encoding::Type::ShiftJIS:
+        Encoding::AppendSjisToUtf8(m_converted, raw);
+        m_text = m_converted;
+        break;
+    default:
+        m_text = raw;
+        break;
+    }
+    return true;
+}
+
+void TextFile::Close() {
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    m_view = nullptr;
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+    m_converted.clear();
+    m_text = std::string_view();
+    m_encoding = Encoding::Type::Unknown;
+}
+
+//=============================================================================
+// TSV Parsing
+//=============================================================================
+namespace Tsv {
+    // Tabs and line breaks are found with memchr, which the CRT vectorizes
+    static void ReadChunk(std::string_view text, std::vector<Row>& rows) {
+        const char* p = text.data();
+        const char* end = p + text.size();
+
+        while (p < end) {
+            const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+            if (!lineEnd) lineEnd = end;
+
+            std::string_view line(p, lineEnd - p);
+            p = lineEnd + 1;
+
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty() || line[0] == '#') continue;
+
+            Row& row = rows.emplace_back();
+            row.line = line;
+
+            const char* field = line.data();
+            const char* fieldsEnd = field + line.size();
+            while (row.fieldCount < kMaxFields) {
+                const char* tab = (const char*)memchr(field, '\t', fieldsEnd - field);
+                if (!tab) {
+                    row.fields[row.fieldCount++] = std::string_view(field, fieldsEnd - field);
+                    break;
+                }
+                row.fields[row.fieldCount++] = std::string_view(field, tab - field);
+                field = tab + 1;
+            }
+        }
+    }
+
+    std::vector<Row> ReadRows(std::string_view text) {
+        size_t chunkCount = (std::max)(text.size() / Constants::kParallelParseChunk, (size_t)1);
+
+        // Cut after the line break nearest each even split point
+        std::vector<std::string_view> chunks;
+        size_t start = 0;
+        for (size_t i = 1; i <= chunkCount && start < text.size(); i++) {
+            size_t cut = (i == chunkCount) ? text.size() : (std::max)((size_t)((uint64_t)text.size() * i / chunkCount), start);
+            size_t lineEnd = text.find('\n', cut);
+            cut = (i == chunkCount || lineEnd == std::string_view::npos) ? text.size() : lineEnd + 1;
+            chunks.push_back(text.substr(start, cut - start));
+            start = cut;
+        }
+
+        if (chunks.size() <= 1) {
+            std::vector<Row> rows;
+            if (!chunks.empty()) ReadChunk(chunks[0], rows);
+            return rows;
+        }
+
+        std::vector<std::vector<Row>> parts(chunks.size());
+        ParallelFor(chunks.size(), [&](size_t i) { ReadChunk(chunks[i], parts[i]); });
+
+        size_t total = 0;
+        for (const auto& part : parts) total += part.size();
+
+        std::vector<Row> rows;
+        rows.reserve(total);
+        for (const auto& part : parts) rows.insert(rows.end(), part.begin(), part.end());
+        return rows;
+    }
+
+    std::string Unescape(std::string_view field) {
+        std::string result;
+        result.reserve(field.size());
+
+        size_t start = 0;
+        for (;;) {
+            size_t slash = field.find('\\', start);
+            if (slash == std::string_view::npos || slash + 1 >= field.size()) break;
+
+            char next = field[slash + 1];
+            if (next != 'n' && next != 't') {
+                result.append(field.data() + start, slash + 1 - start);
+                start = slash + 1;
+                continue;
+            }
+            result.append(field.data() + start, slash - start);
+            result += (next == 'n') ? '\n' : '\t';
+            start = slash + 2;
+        }
+        result.append(field.data() + start, field.size() - start);
+        return result;
+    }
+
+    int ToInt(std::string_view field) {
+        size_t i = 0;
+        while (i < field.size() && (field[i] == ' ' || field[i] == '\t')) i++;
+
+        bool negative = i < field.size() && field[i] == '-';
+        if (i < field.size() && (field[i] == '-' || field[i] == '+')) i++;
+
+        int value = 0;
+        for (; i < field.size() && field[i] >= '0' && field[i] <= '9'; i++) {
+            value = value * 10 + (field[i] - '0');
+        }
+        return negative ? -value : value;
+    }
+}
+
+//=============================================================================
+// String Pool
+//=============================================================================
+StringPool g_stringPool;
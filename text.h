@@ -0,0 +1,200 @@
+#pragma once
+// Encoding conversion, text normalization, word wrapping, and the pool the
+// hooks hand game-ready strings out of
+#include "common.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+//=============================================================================
+// Encoding Detection & Conversion
+//=============================================================================
+namespace Encoding {
+    enum class Type {
+        Unknown,
+        UTF8_BOM,
+        UTF8,
+        ShiftJIS
+    };
+
+    // Detect encoding of a buffer (reads all of it)
+    Type Detect(const char* data, size_t size);
+
+    // Worst-case converted sizes, in bytes (no terminator)
+    inline size_t MaxUtf8Size(size_t sjisLength) { return sjisLength * 3; }
+    inline size_t MaxSjisSize(size_t utf8Length) { return utf8Length; }
+
+    // Convert length bytes into dst in one pass; dst must hold the Max*Size bound.
+    // Returns the bytes written - nothing is NUL-terminated.
+    size_t SjisToUtf8(const char* sjis, size_t length, char* dst);
+    size_t Utf8ToSjis(const char* utf8, size_t length, char* dst);
+
+    // Append the conversion to out, so callers can reuse a scratch string
+    void AppendSjisToUtf8(std::string& out, std::string_view sjis);
+    void AppendUtf8ToSjis(std::string& out, std::string_view utf8);
+
+    // Shift-JIS -> UTF-8
+    std::string SjisToUtf8(const char* sjis);
+
+    // UTF-8 -> Shift-JIS
+    std::string Utf8ToSjis(const char* utf8);
+
+    // Convert any encoding to UTF-8
+    std::string ToUtf8(const std::string& data, Type encoding);
+}
+
+//=============================================================================
+// Shitty Text Fix
+//=============================================================================
+namespace TextFix {
+    // Replace UTF-8 chars that don't exist in SJIS with ones that do
+    std::string NormalizeUtf8(std::string_view utf8);
+}
+
+//=============================================================================
+// Word Wrapping
+//=============================================================================
+namespace WordWrap {
+    bool IsSjisLead(unsigned char c);
+
+    // Wrap at spaces once a line reaches maxWidth single-byte columns
+    std::string Wrap(const std::string& text, int maxWidth);
+}
+
+//=============================================================================
+// Text Files
+//=============================================================================
+// A text file mapped read-only and exposed as UTF-8: a view straight into the
+// mapping when it already is UTF-8, a converted copy only for Shift-JIS
+class TextFile {
+public:
+    TextFile() = default;
+    ~TextFile() { Close(); }
+    TextFile(const TextFile&) = delete;
+    TextFile& operator=(const TextFile&) = delete;
+
+    bool Open(const char* path);
+    void Close();
+
+    std::string_view Text() const { return m_text; }  // BOM stripped
+    Encoding::Type GetEncoding() const { return m_encoding; }
+
+private:
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    const char* m_view = nullptr;
+    std::string m_converted;
+    std::string_view m_text;
+    Encoding::Type m_encoding = Encoding::Type::Unknown;
+};
+
+//=============================================================================
+// TSV Parsing
+//=============================================================================
+// Rows are views into the parsed buffer, which must outlive them
+namespace Tsv {
+    constexpr size_t kMaxFields = 5;
+
+    struct Row {
+        std::string_view line;                // Without the line break
+        std::string_view fields[kMaxFields];  // Columns past kMaxFields are dropped
+        uint32_t fieldCount = 0;
+    };
+
+    // Every line that isn't empty or a '#' comment, in file order. Large buffers
+    // are cut at line boundaries and the chunks split on worker threads.
+    std::vector<Row> ReadRows(std::string_view text);
+
+    // Expand \n and \t escapes in one pass
+    std::string Unescape(std::string_view field);
+
+    // atoi() for a field that isn't NUL-terminated
+    int ToInt(std::string_view field);
+}
+
+//=============================================================================
+// String Pool
+//=============================================================================
+// Hooks hand pool pointers straight to the game, which may hold on to them
+// past the call, so nothing is freed while it could still be on screen. Strings
+// are bump-allocated into the current generation; once that fills up it is
+// retired and only released after a few scene loads.
+class StringPool {
+public:
+    // Bumped when a generation is retired so cached pointers know to re-render
+    uint32_t Generation() const { return m_generation.load(std::memory_order_acquire); }
+
+    // Intern an SJIS string; the result stays valid until its generation is released
+    const char* Store(std::string_view str) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_current.index.find(str);
+        if (it != m_current.index.end()) return it->data();
+
+        if (m_current.bytes + str.size() + 1 > Constants::kStringPoolGenerationBytes &&
+            m_current.bytes > 0) {
+            RetireCurrent();
+        }
+
+        char* data = m_current.Allocate(str.size() + 1);
+        memcpy(data, str.data(), str.size());
+        data[str.size()] = '\0';
+        m_current.index.emplace(data, str.size());
+        return data;
+    }
+
+    // Called per scene load; frees retired generations that have aged out
+    void OnSceneTransition() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_retired.empty()) return;
+
+        for (auto& generation : m_retired) generation.scenesLeft--;
+        while (!m_retired.empty() && m_retired.front().scenesLeft <= 0) {
+            Log("[POOL] Released generation (%u KB)\n", (unsigned)(m_retired.front().bytes / 1024));
+            m_retired.pop_front();
+        }
+    }
+
+private:
+    struct Arena {
+        char* Allocate(size_t size) {
+            if (chunks.empty() || chunkUsed + size > chunkSize) {
+                chunkSize = (std::max)(size, Constants::kStringPoolChunkSize);
+                chunks.emplace_back(new char[chunkSize]);
+                chunkUsed = 0;
+            }
+            char* data = chunks.back().get() + chunkUsed;
+            chunkUsed += size;
+            bytes += size;
+            return data;
+        }
+
+        std::vector<std::unique_ptr<char[]>> chunks;
+        size_t chunkUsed = 0;
+        size_t chunkSize = 0;
+        size_t bytes = 0;
+        std::unordered_set<std::string_view> index;  // Views into chunks
+        int scenesLeft = 0;
+    };
+
+    // Caller holds m_mutex
+    void RetireCurrent() {
+        m_current.index = std::unordered_set<std::string_view>();
+        m_current.scenesLeft = Constants::kStringPoolRetireScenes;
+        m_retired.push_back(std::move(m_current));
+        m_current = Arena();
+        m_generation++;
+        Log("[POOL] Retired generation %u (%d pending)\n", m_generation.load() - 1, (int)m_retired.size());
+    }
+
+    Arena m_current;
+    std::deque<Arena> m_retired;
+    std::mutex m_mutex;
+    std::atomic<uint32_t> m_generation{1};
+};
+
+extern StringPool g_stringPool;
@@ -0,0 +1,1232 @@
+#include "translation_db.h"
+
+//=============================================================================
+// RLD Script
+//=============================================================================
+namespace RldScript {
+    constexpr uint32_t kDefaultSeed = 0x20100806;
+    constexpr uint32_t kDefSeed = 0xAE85A916;        // def.rld has its own key
+    constexpr size_t kEncryptedStart = 0x10;
+    constexpr size_t kEncryptedLimit = 0xFFCF;       // Only the first ~64 KB is encrypted
+    constexpr uint32_t kCmdChangeScenario = 0x11;
+    constexpr uint32_t kCmdMessage = 0x1C;
+    constexpr uint32_t kMaxCommands = 50000;
+
+    // "rld\\sc_01.rld" -> "sc_01", the form liteLoad() paths reduce to
+    static std::string FileIdOf(std::string_view path) {
+        size_t slash = path.find_last_of("\\/");
+        if (slash != std::string_view::npos) path.remove_prefix(slash + 1);
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string_view::npos) path = path.substr(0, dot);
+        return std::string(path);
+    }
+
+    // First 256 tempered outputs of the engine's MT, each XORed with the seed
+    static void GenerateKeyTable(uint32_t seed, uint32_t keys[256]) {
+        MersenneTwister rng(seed);
+        for (int i = 0; i < 256; i++) keys[i] = rng.Next() ^ seed;
+    }
+
+    static void Decrypt(std::string& data, uint32_t seed) {
+        uint32_t keys[256];
+        GenerateKeyTable(seed, keys);
+
+        size_t end = (std::min)(data.size(), kEncryptedLimit);
+        end -= end % 4;
+
+        uint32_t keyIndex = 0;
+        for (size_t i = kEncryptedStart; i + 4 <= end; i += 4) {
+            uint32_t value;
+            memcpy(&value, &data[i], sizeof(value));
+            value ^= keys[keyIndex++ & 0xFF];
+            memcpy(&data[i], &value, sizeof(value));
+        }
+    }
+
+    bool Parse(const std::string& data, Script& script) {
+        if (data.size() < 16 || data.compare(1, 3, "DLR") != 0) return false;
+
+        uint32_t commandOffset, commandCount;
+        memcpy(&commandOffset, &data[8], sizeof(commandOffset));
+        memcpy(&commandCount, &data[12], sizeof(commandCount));
+        if (commandOffset >= data.size()) return false;
+
+        size_t offset = commandOffset;
+        std::vector<std::string_view> strings;
+        for (uint32_t index = 0; index < commandCount && index < kMaxCommands; index++) {
+            if (offset + 4 > data.size()) break;
+
+            uint32_t header;
+            memcpy(&header, &data[offset], sizeof(header));
+            offset += 4;
+
+            uint32_t type = header & 0xFFFF;
+            uint32_t dwordCount = (header >> 16) & 0xFF;
+            uint32_t stringCount = (header >> 24) & 0x0F;
+            if (type > 0x1000 || dwordCount > 50) break;  // Lost sync - stop rather than guess
+
+            offset = (std::min)(offset + (size_t)dwordCount * 4, data.size());
+
+            strings.clear();
+            for (uint32_t i = 0; i < stringCount && offset < data.size(); i++) {
+                size_t end = data.find('\0', offset);
+                if (end == std::string::npos) end = data.size();
+                strings.emplace_back(data.data() + offset, end - offset);
+                offset = end + 1;
+            }
+
+            // The text is the last string; an inline speaker name comes first
+            if (type == kCmdMessage && !strings.empty() && !strings.back().empty()) {
+                script.messages.push_back({ (int)index, std::string(strings.back()) });
+            } else if (type == kCmdChangeScenario && !strings.empty() && !strings[0].empty()) {
+                std::string target = FileIdOf(strings[0]);
+                if (std::find(script.successors.begin(), script.successors.end(), target) ==
+                    script.successors.end()) {
+                    script.successors.push_back(std::move(target));
+                }
+            }
+        }
+        return true;
+    }
+
+    bool Load(const char* path, Script& script) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+
+        std::string data((size_t)file.tellg(), '\0');
+        file.seekg(0);
+        file.read(&data[0], data.size());
+        if (!file || data.size() < 16 || data.compare(1, 3, "DLR") != 0) return false;
+
+        const char* name = path;
+        for (const char* p = path; *p; p++) {
+            if (*p == '\\' || *p == '/') name = p + 1;
+        }
+        Decrypt(data, (_stricmp(name, "def.rld") == 0) ? kDefSeed : kDefaultSeed);
+        return Parse(data, script);
+    }
+}
+
+//=============================================================================
+// Translation Database
+//=============================================================================
+std::mutex g_sceneMutex;
+std::string g_currentFile;
+std::string g_currentLabel;
+std::atomic<const void*> g_currentScene{nullptr};
+
+//-----------------------------------------------------------------------------
+// MissDump
+//-----------------------------------------------------------------------------
+// Post() only hashes, copies and queues; the first miss of a batch wakes the
+// writer, which waits kMissDumpBatchMs for more before one WriteFile. The
+// file stays open (and readable by others) for the whole session.
+namespace MissDump {
+    struct Miss {
+        std::string text;  // UTF-8
+        const char* type;
+        std::string file;  // Scene at miss time, empty before the first load
+        std::string label;
+    };
+
+    static std::mutex g_queueMutex;
+    static std::vector<Miss> g_queue;
+    static std::unordered_set<uint64_t> g_seen;  // (type, text) hashes already queued
+    static std::mutex g_writeMutex;              // Serializes Flush() between the writer and Stop()
+    static HANDLE g_file = INVALID_HANDLE_VALUE;
+    static HANDLE g_wakeEvent = nullptr;
+    static HANDLE g_stopEvent = nullptr;
+    static std::atomic<bool> g_active{false};
+
+    // Over the type, a separator and the text
+    static uint64_t HashMiss(std::string_view text, const char* type) {
+        return HashBytes(HashBytes(HashBytes(kHashSeed, type), "\t"), text);
+    }
+
+    static void AppendEscaped(std::string& out, std::string_view text) {
+        for (char c : text) {
+            if (c == '\n') out += "\\n";
+            else if (c == '\t') out += "\\t";
+            else if (c != '\r') out += c;
+        }
+    }
+
+    static void Flush() {
+        std::lock_guard<std::mutex> writeLock(g_writeMutex);
+
+        std::vector<Miss> batch;
+        {
+            std::lock_guard<std::mutex> lock(g_queueMutex);
+            batch.swap(g_queue);
+        }
+        if (batch.empty() || g_file == INVALID_HANDLE_VALUE) return;
+
+        // FILE, INDEX, TYPE, ORIGINAL, (empty) TRANSLATION, then the scene and label
+        // for QA. FILE stays RUNTIME so a row pasted back into translation.tsv
+        // doesn't join that scene's block and claim a command index it never had.
+        std::string out;
+        for (const Miss& miss : batch) {
+            out += "RUNTIME\t0\t";
+            out += miss.type;
+            out += '\t';
+            AppendEscaped(out, miss.text);
+            out += "\t\t";
+            AppendEscaped(out, miss.file);
+            out += '\t';
+            AppendEscaped(out, miss.label);
+            out += "\r\n";
+        }
+
+        DWORD written = 0;
+        if (!WriteFile(g_file, out.data(), (DWORD)out.size(), &written, nullptr)) {
+            Log("[TL] Cannot write %s (%lu)\n", Config::untranslatedLog, GetLastError());
+        }
+    }
+
+    // Stop() can't wait for this thread, so the thread closes the events itself
+    // once it is done waiting on them
+    static DWORD WINAPI WriterThreadProc(LPVOID) {
+        HANDLE wake[2] = { g_stopEvent, g_wakeEvent };
+        for (;;) {
+            if (WaitForMultipleObjects(2, wake, FALSE, INFINITE) == WAIT_OBJECT_0) break;
+            if (WaitForSingleObject(g_stopEvent, Constants::kMissDumpBatchMs) == WAIT_OBJECT_0) break;
+            Flush();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(g_queueMutex);  // Post() signals under it
+            CloseHandle(g_wakeEvent);
+            g_wakeEvent = nullptr;
+        }
+        CloseHandle(g_stopEvent);
+        g_stopEvent = nullptr;
+        return 0;
+    }
+
+    void Start() {
+        if (!Config::dumpUntranslated || g_active.load()) return;
+
+        g_file = CreateFileA(Config::untranslatedLog, FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (g_file == INVALID_HANDLE_VALUE) {
+            Log("[TL] Cannot open %s - untranslated text won't be dumped\n", Config::untranslatedLog);
+            return;
+        }
+
+        g_wakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        g_stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        HANDLE thread = CreateThread(nullptr, 0, WriterThreadProc, nullptr, 0, nullptr);
+        if (!thread) {
+            Log("[TL] Cannot start the untranslated text writer\n");
+            CloseHandle(g_wakeEvent);
+            CloseHandle(g_stopEvent);
+            CloseHandle(g_file);
+            g_wakeEvent = g_stopEvent = nullptr;
+            g_file = INVALID_HANDLE_VALUE;
+            return;
+        }
+        CloseHandle(thread);
+        g_active.store(true, std::memory_order_release);
+    }
+
+    void Post(std::string_view utf8Text, const char* type) {
+        if (!g_active.load(std::memory_order_acquire)) return;
+
+        {
+            std::lock_guard<std::mutex> lock(g_queueMutex);
+            if (!g_seen.insert(HashMiss(utf8Text, type)).second) return;
+        }
+
+        Miss miss{ std::string(utf8Text), type, std::string(), std::string() };
+        {
+            std::lock_guard<std::mutex> sceneLock(g_sceneMutex);
+            miss.file = g_currentFile;
+            miss.label = g_currentLabel;
+        }
+
+        std::lock_guard<std::mutex> lock(g_queueMutex);
+        bool wake = g_queue.empty();
+        g_queue.push_back(std::move(miss));
+        if (wake && g_wakeEvent) SetEvent(g_wakeEvent);
+    }
+
+    // Doesn't wait for the writer - from DllMain it can't exit until we return.
+    // The writer closes the events when it sees g_stopEvent.
+    void Stop() {
+        if (!g_active.exchange(false)) return;
+        SetEvent(g_stopEvent);
+        Flush();
+
+        std::lock_guard<std::mutex> writeLock(g_writeMutex);
+        CloseHandle(g_file);
+        g_file = INVALID_HANDLE_VALUE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// TranslationDB::EntryTable
+//-----------------------------------------------------------------------------
+void TranslationDB::EntryTable::Set(std::string_view original, std::string_view translated, int index) {
+    auto keyOf = [this](uint32_t id) { return OriginalOf(id); };
+    uint32_t id = m_byOriginal.Insert(original, (uint32_t)HashBytes(kHashSeed, original), (uint32_t)m_rows.size(), keyOf);
+    if (id != FlatIndex::kNone) {
+        Row& row = m_rows[id];
+        row.translated.assign(translated);
+        if (index >= 0) row.index = index;
+        return;
+    }
+    m_rows.push_back({ std::string(original), std::string(translated), std::string(), index, true });
+}
+
+// Image rows were written from a sealed table, so originals are distinct already
+void TranslationDB::EntryTable::Append(std::string_view original, std::string_view translated,
+    std::string_view sjisKey) {
+    auto keyOf = [this](uint32_t id) { return OriginalOf(id); };
+    m_byOriginal.Insert(original, (uint32_t)HashBytes(kHashSeed, original), (uint32_t)m_rows.size(), keyOf);
+    m_rows.push_back({ std::string(original), std::string(translated), std::string(sjisKey), -1, false });
+}
+
+void TranslationDB::EntryTable::SetIndex(std::string_view original, int index) {
+    auto keyOf = [this](uint32_t id) { return OriginalOf(id); };
+    uint32_t id = m_byOriginal.Find(original, (uint32_t)HashBytes(kHashSeed, original), keyOf);
+    if (id != FlatIndex::kNone) m_rows[id].index = index;
+}
+
+// One CP932 conversion per key at load time instead of one per hook call. Ids
+// don't change, so the index over the originals carries over from staging.
+void TranslationDB::EntryTable::Seal() {
+    size_t bytes = 0;
+    for (Row& row : m_rows) {
+        if (row.convertKey) row.sjisKey = Encoding::Utf8ToSjis(row.original.c_str());
+        bytes += row.original.size() + row.translated.size() + row.sjisKey.size() + 3;
+    }
+
+    m_size = m_rows.size();
+    m_arena.reset(new char[bytes]);
+    m_entries.reset(new Translation[m_size]);
+    m_byKey.Reserve(m_size);
+
+    char* out = m_arena.get();
+    auto place = [&](const std::string& bytesIn) {
+        memcpy(out, bytesIn.data(), bytesIn.size());
+        out[bytesIn.size()] = '\0';
+        std::string_view placed(out, bytesIn.size());
+        out += bytesIn.size() + 1;
+        return placed;
+    };
+
+    auto keyOf = [this](uint32_t id) { return m_entries[id].sjisKey; };
+    for (uint32_t id = 0; id < (uint32_t)m_size; id++) {
+        const Row& row = m_rows[id];
+        Translation& entry = m_entries[id];
+        entry.original = place(row.original);
+        entry.text = place(row.translated);
+        entry.index = row.index;
+
+        // Two originals can collapse to the same CP932 bytes; the first keeps the key
+        std::string_view key = place(row.sjisKey);
+        if (!key.empty() && m_byKey.Insert(key, (uint32_t)HashBytes(kHashSeed, key), id, keyOf) == FlatIndex::kNone) {
+            entry.sjisKey = key;
+        }
+    }
+
+    std::vector<Row>().swap(m_rows);
+}
+
+const TranslationDB::Translation* TranslationDB::EntryTable::Find(std::string_view sjis, uint64_t hash) const {
+    uint32_t id = m_byKey.Find(sjis, (uint32_t)hash, [this](uint32_t id) { return m_entries[id].sjisKey; });
+    return (id != FlatIndex::kNone) ? &m_entries[id] : nullptr;
+}
+
+const TranslationDB::Translation* TranslationDB::EntryTable::FindOriginal(std::string_view utf8) const {
+    uint32_t id = m_byOriginal.Find(utf8, (uint32_t)HashBytes(kHashSeed, utf8),
+        [this](uint32_t id) { return m_entries[id].original; });
+    return (id != FlatIndex::kNone) ? &m_entries[id] : nullptr;
+}
+
+TranslationDB::Translation* TranslationDB::EntryTable::FindOriginal(std::string_view utf8) {
+    return const_cast<Translation*>(static_cast<const EntryTable*>(this)->FindOriginal(utf8));
+}
+
+//-----------------------------------------------------------------------------
+// TranslationDB::FileBlock
+//-----------------------------------------------------------------------------
+// Labels must be added in index order
+void TranslationDB::FileBlock::AddLabel(int index, std::string_view name) {
+    SceneLabel label = { index, std::string(name), std::string(name) };
+    size_t bracket = label.chapter.rfind(" [");
+    if (bracket != std::string::npos) label.chapter.erase(bracket);
+    sceneLabels.push_back(std::move(label));
+}
+
+void TranslationDB::FileBlock::Seal() {
+    names.Seal();
+    labels.Seal();
+}
+
+// Install a shard built in place (parsed from the TSV); the keys go to the snapshot directory
+void TranslationDB::FileBlock::SetShard(std::unique_ptr<Shard> shard) {
+    messageKeys.clear();
+    messageKeys.reserve(shard->messages.KeyCount());
+    for (const Translation& translation : shard->messages) {
+        if (!translation.sjisKey.empty()) messageKeys.push_back(HashBytes(kHashSeed, translation.sjisKey));
+    }
+    m_ownedShard = std::move(shard);
+    m_shard.store(m_ownedShard.get(), std::memory_order_release);
+}
+
+// Read on first use, from whichever thread gets there first; later calls are one load
+const TranslationDB::Shard& TranslationDB::FileBlock::GetShard() const {
+    if (const Shard* shard = m_shard.load(std::memory_order_acquire)) return *shard;
+
+    std::lock_guard<std::mutex> lock(m_shardMutex);
+    if (!m_ownedShard) {
+        m_ownedShard = ReadShard();
+        m_source.image.reset();  // The image unmaps once every block has let go of it
+        m_shard.store(m_ownedShard.get(), std::memory_order_release);
+    }
+    return *m_ownedShard;
+}
+
+//-----------------------------------------------------------------------------
+// TranslationDB::FileBlock::Shard
+//-----------------------------------------------------------------------------
+void TranslationDB::FileBlock::Shard::Seal() {
+    contextualNames.Seal();
+    messages.Seal();
+}
+
+// Lines must be added in index order, once messages is sealed
+void TranslationDB::FileBlock::Shard::AddLine(int index, std::string_view original, std::string_view translated) {
+    const Translation* shared = messages.FindOriginal(original);
+    if (shared && shared->Text() == translated) {
+        lines.push_back({ index, Translation::kNoLabel, shared });
+    } else {
+        lines.push_back({ index, Translation::kNoLabel, nullptr });
+        lineOverrides.Append(original, translated, std::string_view());
+    }
+}
+
+// Give each scene line the highest label index <= its own, once, instead of per hit
+void TranslationDB::FileBlock::Shard::ResolveScenes(const std::vector<SceneLabel>& sceneLabels) {
+    for (Translation& translation : messages) {
+        if (translation.index < 0) continue;
+
+        auto it = std::upper_bound(sceneLabels.begin(), sceneLabels.end(), translation.index,
+            [](int index, const SceneLabel& label) { return index < label.index; });
+        translation.label = (int32_t)(it - sceneLabels.begin()) - 1;
+    }
+}
+
+// Hang each "name|message" entry off its message, so a spoken line needs one hash
+void TranslationDB::FileBlock::Shard::ResolveSpeakers() {
+    for (const Translation& name : contextualNames) {
+        std::string_view contextKey = name.sjisKey;
+        if (contextKey.empty()) continue;
+
+        // Split on the UTF-8 key - '|' can be a CP932 trail byte
+        std::string_view original = name.Original();
+        size_t bar = original.find('|');
+        if (bar == std::string_view::npos) continue;
+
+        Translation* message = messages.FindOriginal(original.substr(bar + 1));
+        if (!message || message->sjisKey.empty()) continue;
+
+        // The CP932 context key is sjisName + "|" + the message's CP932 key
+        std::string_view messageKey = message->sjisKey;
+        if (contextKey.size() <= messageKey.size() + 1) continue;
+
+        size_t split = contextKey.size() - messageKey.size() - 1;
+        if (contextKey[split] != '|' || contextKey.substr(split + 1) != messageKey) continue;
+
+        message->speakers.push_back({ contextKey.substr(0, split), &name });
+    }
+}
+
+// Lines that matched their message share its Translation; the rest get the
+// override AddLine queued for them, in the same order, borrowing the shared speakers
+void TranslationDB::FileBlock::Shard::ResolveLines(const std::vector<SceneLabel>& sceneLabels) {
+    lineOverrides.Seal();
+    Translation* own = lineOverrides.begin();
+
+    for (ScriptLine& line : lines) {
+        auto labelIt = std::upper_bound(sceneLabels.begin(), sceneLabels.end(), line.index,
+            [](int index, const SceneLabel& label) { return index < label.index; });
+        line.label = (int32_t)(labelIt - sceneLabels.begin()) - 1;
+        if (line.translation) continue;
+
+        own->index = line.index;
+        own->label = line.label;
+        if (const Translation* shared = messages.FindOriginal(own->Original())) own->speakers = shared->speakers;
+        line.translation = own++;
+    }
+}
+
+const TranslationDB::FileBlock::ScriptLine* TranslationDB::FileBlock::Shard::FindLine(int index) const {
+    auto it = std::lower_bound(lines.begin(), lines.end(), index,
+        [](const ScriptLine& line, int value) { return line.index < value; });
+    return (it != lines.end() && it->index == index) ? &*it : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// TranslationDB::Snapshot - building
+//-----------------------------------------------------------------------------
+bool TranslationDB::Snapshot::Load(const char* tsvPath, const char* namesPath, const Snapshot* previous) {
+    // Capture signatures before reading, so an edit made mid-parse leaves the image stale
+    std::string imagePath = std::string(tsvPath) + ".bin";
+    TranslationImage::Signature tsvSig = TranslationImage::GetSignature(tsvPath);
+    TranslationImage::Signature namesSig = TranslationImage::GetSignature(namesPath);
+
+    // === STEP 0: On first load, use the binary image if it still matches the sources ===
+    if (!previous && Config::useBinaryCache && LoadImage(imagePath, tsvSig, namesSig, tsvPath, namesPath)) {
+        Link();
+        return true;
+    }
+
+    int reused = 0;
+    int parsed = 0;
+
+    // === STEP 1: Load global names from unique_names.tsv ===
+    TextFile namesFile;
+    if (namesPath && namesFile.Open(namesPath)) {
+        uint64_t hash = HashBytes(kHashSeed, namesFile.Text());
+
+        if (previous && previous->globalNames && previous->globalNames->hash == hash) {
+            globalNames = previous->globalNames;
+            reused++;
+        } else {
+            globalNames = ParseNames(namesFile.Text(), hash);
+            parsed++;
+        }
+    } else {
+        if (namesPath) Log("[TL] No global names file: %s\n", namesPath);
+        globalNames = std::make_shared<FileBlock>();
+    }
+
+    // === STEP 2: Load translation.tsv (overrides global) ===
+    TextFile tsvFile;
+    if (!tsvFile.Open(tsvPath)) {
+        Log("[TL] Cannot open: %s\n", tsvPath);
+        Link();
+        return globalNames->counts.globalNames > 0;  // Still OK if we loaded names
+    }
+    Encoding::Type encoding = tsvFile.GetEncoding();
+
+    // Split into rows across cores, then group them by fileId in file order
+    std::vector<Tsv::Row> rows = Tsv::ReadRows(tsvFile.Text());
+
+    struct PendingBlock {
+        std::string fileId;
+        std::vector<const Tsv::Row*> rows;
+    };
+    std::vector<PendingBlock> pending;
+    std::unordered_map<std::string_view, size_t> pendingById;
+
+    for (const Tsv::Row& row : rows) {
+        auto result = pendingById.try_emplace(row.fields[0], pending.size());
+        if (result.second) {
+            pending.push_back({ std::string(row.fields[0]), {} });
+        }
+        pending[result.first->second].rows.push_back(&row);
+    }
+
+    // Carry over every block whose lines hash the same as last time
+    std::unordered_map<std::string_view, const BlockPtr*> previousById;
+    if (previous) {
+        previousById.reserve(previous->files.size());
+        for (const auto& block : previous->files) previousById.emplace(block->fileId, &block);
+    }
+
+    // Blocks are independent, so hash and build them in parallel too
+    std::atomic<int> reusedBlocks{0};
+    std::atomic<int> parsedBlocks{0};
+    files.assign(pending.size(), nullptr);
+
+    ParallelFor(pending.size(), [&](size_t i) {
+        const PendingBlock& block = pending[i];
+        uint64_t hash = kHashSeed;
+        for (const Tsv::Row* row : block.rows) hash = HashBytes(HashBytes(hash, row->line), "\n");
+
+        auto it = previousById.find(block.fileId);
+        if (it != previousById.end() && (*it->second)->hash == hash) {
+            files[i] = *it->second;
+            reusedBlocks++;
+        } else {
+            files[i] = ParseBlock(block.fileId, hash, block.rows);
+            parsedBlocks++;
+        }
+    });
+    reused += reusedBlocks;
+    parsed += parsedBlocks;
+
+    Link();
+
+    if (previous) {
+        Log("[TL] Reparsed %d of %d blocks (%d unchanged)\n", parsed, parsed + reused, reused);
+    } else {
+        LogLoaded(EncodingName(encoding), TotalCounts(), tsvPath, namesPath);
+    }
+
+    // Even with nothing reparsed, an edit that only drops or moves blocks leaves
+    // the image's signatures stale - SaveImage then writes just a new directory
+    if (Config::useBinaryCache) {
+        SaveImage(imagePath, tsvSig, namesSig, encoding, previous, parsed > 0);
+    }
+
+    return true;
+}
+
+TranslationDB::BlockPtr TranslationDB::Snapshot::FindBlock(const std::string& fileId) const {
+    for (const auto& block : files) {
+        if (_stricmp(block->fileId.c_str(), fileId.c_str()) == 0) return block;
+    }
+    return nullptr;
+}
+
+// Rebuild the snapshot-wide indexes - pointer copies only, no parsing, conversion or shard reads
+void TranslationDB::Snapshot::Link() {
+    size_t nameCount = globalNames->names.KeyCount();
+    size_t labelCount = 0;
+    for (const auto& block : files) {
+        nameCount += block->names.KeyCount();
+        labelCount += block->labels.KeyCount();
+    }
+
+    names.Reserve(nameCount);
+    labels.Reserve(labelCount);
+
+    names.Merge(globalNames->names, globalNames.get());
+    for (const auto& block : files) {
+        names.Merge(block->names, block.get());
+        labels.Merge(block->labels, block.get());
+    }
+
+    messages.Build(files);
+    LinkLabelBases();
+}
+
+// Save files name a scene without the " [N]" suffix translation.tsv gives it,
+// so index every numbered label under its base name as well
+void TranslationDB::Snapshot::LinkLabelBases() {
+    std::unordered_map<std::string_view, int> numbers;
+    labelBases.Reserve(labels.Size());
+
+    labels.ForEach([&](std::string_view key, const MergedIndex::Hit& hit) {
+        std::string_view base;
+        int number = 0;
+        if (!SplitLabelSuffix(key, base, number)) return;
+
+        auto result = numbers.try_emplace(base, number);
+        if (!result.second) {
+            if (result.first->second <= number) return;
+            result.first->second = number;
+        }
+        labelBases.Set(base, hit);  // A prefix of key, so it lives as long as key does
+    });
+}
+
+// "name [12]" -> "name", 12. Space is never a CP932 trail byte, so " [" can't be half a character.
+bool TranslationDB::Snapshot::SplitLabelSuffix(std::string_view label, std::string_view& base, int& number) {
+    if (label.size() < 4 || label.back() != ']') return false;
+
+    size_t open = label.rfind(" [");
+    if (open == std::string_view::npos || open == 0) return false;
+
+    std::string_view digits = label.substr(open + 2, label.size() - open - 3);
+    if (digits.empty() || digits.size() > 6) return false;
+
+    number = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '9') return false;
+        number = number * 10 + (c - '0');
+    }
+
+    base = label.substr(0, open);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// TranslationDB::MessageDirectory
+//-----------------------------------------------------------------------------
+void TranslationDB::MessageDirectory::Build(const std::vector<BlockPtr>& files) {
+    size_t count = 0;
+    for (const auto& block : files) count += block->messageKeys.size();
+
+    m_slots.clear();
+    m_slots.reserve(count);
+    for (const auto& block : files) {
+        for (uint64_t hash : block->messageKeys) m_slots.push_back({ hash, block.get() });
+    }
+
+    // Stable, so equal hashes stay in block order and the last of each run wins
+    std::stable_sort(m_slots.begin(), m_slots.end(),
+        [](const Slot& a, const Slot& b) { return a.hash < b.hash; });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m_slots.size(); i++) {
+        if (i + 1 < m_slots.size() && m_slots[i + 1].hash == m_slots[i].hash) continue;
+        m_slots[kept++] = m_slots[i];
+    }
+    m_slots.resize(kept);
+    m_slots.shrink_to_fit();
+}
+
+// The owning block's shard confirms the key, so a hash collision is only ever a miss
+TranslationDB::MergedIndex::Hit TranslationDB::MessageDirectory::Find(std::string_view sjis) const {
+    uint64_t hash = HashBytes(kHashSeed, sjis);
+    auto it = std::lower_bound(m_slots.begin(), m_slots.end(), hash,
+        [](const Slot& slot, uint64_t value) { return slot.hash < value; });
+    if (it == m_slots.end() || it->hash != hash) return { nullptr, nullptr };
+
+    const Translation* translation = it->block->GetShard().messages.Find(sjis, hash);
+    return { translation, translation ? it->block : nullptr };
+}
+
+TranslationImage::Counts TranslationDB::Snapshot::TotalCounts() const {
+    TranslationImage::Counts total = globalNames->counts;
+    for (const auto& block : files) {
+        total.contextualNames += block->counts.contextualNames;
+        total.texts += block->counts.texts;
+        total.choices += block->counts.choices;
+        total.labels += block->counts.labels;
+    }
+    return total;
+}
+
+TranslationDB::BlockPtr TranslationDB::Snapshot::ParseBlock(const std::string& fileId, uint64_t hash,
+    const std::vector<const Tsv::Row*>& rows) {
+    auto block = std::make_shared<FileBlock>();
+    block->fileId = fileId;
+    block->hash = hash;
+    auto shard = std::make_unique<Shard>();
+
+    // First pass: collect entries by index
+    std::map<int, std::string> namesByIndex;
+    std::map<int, std::string> originalNamesByIndex;
+    std::map<int, std::string> textsByIndex;
+    std::map<int, std::string> translationsByIndex;
+    std::map<int, std::string> labelsByIndex;
+
+    for (const Tsv::Row* row : rows) {
+        if (row->fieldCount < 5 || row->fields[4].empty()) continue;
+
+        int index = Tsv::ToInt(row->fields[1]);
+        std::string_view type = row->fields[2];
+        std::string original = Tsv::Unescape(row->fields[3]);
+        std::string translated = Tsv::Unescape(row->fields[4]);
+
+        if (type == "NAME") {
+            namesByIndex[index] = translated;
+            originalNamesByIndex[index] = original;
+        } else if (type == "TEXT" || type == "MSG") {
+            textsByIndex[index] = original;
+            translationsByIndex[index] = translated;
+            shard->messages.Set(original, translated, index);
+            block->counts.texts++;
+        } else if (type == "LABEL") {
+            block->labels.Set(original, translated);
+            labelsByIndex[index] = translated.empty() ? original : translated;
+            block->counts.labels++;
+        } else if (type.substr(0, 7) == "CHOICE_") {
+            shard->messages.Set(original, translated);
+            block->counts.choices++;
+        }
+    }
+
+    // Second pass: build contextual names (these OVERRIDE global)
+    for (const auto& [index, translatedName] : namesByIndex) {
+        std::string originalName = originalNamesByIndex[index];
+
+        auto textIt = textsByIndex.find(index);
+        if (textIt != textsByIndex.end()) {
+            // Contextual: "name|message" -> translation
+            std::string contextKey = originalName + "|" + textIt->second;
+            shard->contextualNames.Set(contextKey, translatedName);
+            block->counts.contextualNames++;
+        } else {
+            // No text at same index - override global
+            block->names.Set(originalName, translatedName);
+            // Don't count as a global name - those come from unique_names
+        }
+    }
+
+    block->sceneLabels.reserve(labelsByIndex.size());
+    for (const auto& [index, label] : labelsByIndex) {
+        block->AddLabel(index, label);
+    }
+
+    block->Seal();
+    shard->Seal();
+
+    shard->lines.reserve(textsByIndex.size());
+    for (const auto& [index, original] : textsByIndex) {
+        shard->AddLine(index, original, translationsByIndex[index]);
+    }
+
+    shard->ResolveScenes(block->sceneLabels);
+    shard->ResolveSpeakers();
+    shard->ResolveLines(block->sceneLabels);
+    block->SetShard(std::move(shard));
+    return block;
+}
+
+TranslationDB::BlockPtr TranslationDB::Snapshot::ParseNames(std::string_view utf8Content, uint64_t hash) {
+    auto block = std::make_shared<FileBlock>();
+    block->hash = hash;
+
+    for (const Tsv::Row& row : Tsv::ReadRows(utf8Content)) {
+        // Skip header line; the second column ends at the count column if there is one
+        if (row.line.substr(0, 8) == "ORIGINAL" || row.fieldCount < 2) continue;
+
+        std::string_view original = row.fields[0];
+        std::string_view translated = row.fields[1];
+
+        // Trim whitespace
+        while (!translated.empty() && translated.back() == ' ') translated.remove_suffix(1);
+
+        // Skip if empty (user hasn't filled it in yet)
+        if (original.empty() || translated.empty()) continue;
+
+        block->names.Set(Tsv::Unescape(original), Tsv::Unescape(translated));
+        block->counts.globalNames++;
+    }
+
+    block->Seal();
+    block->SetShard(std::make_unique<Shard>());
+    return block;
+}
+
+// Rebuild the blocks straight from a matching translation.tsv.bin. Only what every
+// scene shares is read here; each block keeps the image to read its shard from later.
+bool TranslationDB::Snapshot::LoadImage(const std::string& imagePath,
+    const TranslationImage::Signature& tsvSig, const TranslationImage::Signature& namesSig,
+    const char* tsvPath, const char* namesPath) {
+    using namespace TranslationImage;
+
+    auto image = std::make_shared<View>();
+    if (!image->Open(imagePath.c_str())) return false;
+
+    const Header& header = image->GetHeader();
+    if (header.tsv != tsvSig || header.names != namesSig) {
+        Log("[TL] Binary cache is stale, reparsing %s\n", tsvPath);
+        return false;
+    }
+
+    std::vector<std::shared_ptr<FileBlock>> blocks;
+
+    bool ok =
+        image->ReadBlocks([&](uint32_t, const BlockRecord& record, std::string_view fileId) {
+            auto block = std::make_shared<FileBlock>();
+            block->fileId = fileId;
+            block->hash = record.hash;
+            block->counts = record.counts;
+
+            auto keyedInto = [&](EntryTable& table) {
+                return [&](uint32_t owner, std::string_view key, std::string_view value, std::string_view sjisKey) {
+                    if (owner != record.owner) return false;
+                    table.Append(key, value, sjisKey);
+                    return true;
+                };
+            };
+
+            block->messageKeys.reserve(record.ranges[kMessageKeys].count);
+            if (!image->ReadHashes(record, [&](uint64_t hash) { block->messageKeys.push_back(hash); }) ||
+                !image->ReadKeyed(record, kNames, keyedInto(block->names)) ||
+                !image->ReadKeyed(record, kLabels, keyedInto(block->labels)) ||
+                !image->ReadIndexed(record, kLabelsByIndex, [&](uint32_t owner, int index, std::string_view value) {
+                    if (owner != record.owner) return false;
+                    block->AddLabel(index, value);
+                    return true;
+                })) {
+                return false;
+            }
+
+            block->SetSource({ image, record });
+            block->stored = { header.id, record };
+            blocks.push_back(std::move(block));
+            return true;
+        }) &&
+        !blocks.empty();
+
+    if (!ok) {
+        Log("[TL] Binary cache is corrupt, reparsing %s\n", tsvPath);
+        return false;
+    }
+
+    for (const auto& block : blocks) block->Seal();
+
+    // Block 0 is always unique_names.tsv
+    globalNames = blocks[0];
+    files.assign(blocks.begin() + 1, blocks.end());
+
+    std::string source = std::string(EncodingName((Encoding::Type)header.encoding)) + ", cached";
+    LogLoaded(source.c_str(), TotalCounts(), tsvPath, namesPath);
+    return true;
+}
+
+// Caller holds m_shardMutex. A block with no image behind it has nothing to read.
+std::unique_ptr<TranslationDB::Shard> TranslationDB::FileBlock::ReadShard() const {
+    using namespace TranslationImage;
+
+    auto shard = std::make_unique<Shard>();
+    if (!m_source.image) return shard;
+
+    const View& image = *m_source.image;
+    const BlockRecord& record = m_source.record;
+
+    auto keyedInto = [&](EntryTable& table) {
+        return [&](uint32_t owner, std::string_view key, std::string_view value, std::string_view sjisKey) {
+            if (owner != record.owner) return false;
+            table.Append(key, value, sjisKey);
+            return true;
+        };
+    };
+
+    bool ok =
+        image.ReadKeyed(record, kContextualNames, keyedInto(shard->contextualNames)) &&
+        image.ReadKeyed(record, kMessages, keyedInto(shard->messages)) &&
+        image.ReadInts(record, kMessageToIndex,
+            [&](uint32_t owner, std::string_view key, int value) {
+                if (owner != record.owner) return false;
+                shard->messages.SetIndex(key, value);
+                return true;
+            });
+
+    // Lines are matched against the sealed messages
+    shard->Seal();
+    shard->lines.reserve(record.ranges[kLines].count);
+    ok = ok &&
+        image.ReadLines(record,
+            [&](uint32_t owner, int index, std::string_view original, std::string_view value) {
+                if (owner != record.owner) return false;
+                shard->AddLine(index, original, value);
+                return true;
+            });
+
+    if (!ok) {
+        Log("[TL] Binary cache shard for %s is corrupt - its lines stay untranslated\n", fileId.c_str());
+        return std::make_unique<Shard>();
+    }
+
+    shard->ResolveScenes(sceneLabels);
+    shard->ResolveSpeakers();
+    shard->ResolveLines(sceneLabels);
+    return shard;
+}
+
+// Serialize the snapshot, unique_names.tsv first. Each written block's records
+// are kept together per section, and the block table (written last) records where.
+// If the image on disk is the one every carried-over block was read from or saved
+// to, only the blocks parsed since are written - appended, with a new directory
+// that points the others at their existing records. Appends stop once they have
+// doubled the image; the next save writes it whole again. Without reparsed
+// blocks, an image already stamped with these signatures is left alone.
+void TranslationDB::Snapshot::SaveImage(const std::string& imagePath,
+    const TranslationImage::Signature& tsvSig, const TranslationImage::Signature& namesSig,
+    Encoding::Type encoding, const Snapshot* previous, bool reparsed) const {
+    using namespace TranslationImage;
+
+    std::vector<const FileBlock*> blocks;
+    blocks.reserve(files.size() + 1);
+    blocks.push_back(globalNames.get());
+    for (const auto& block : files) blocks.push_back(block.get());
+
+    // === Append, if the image on disk still backs every stored block ===
+    Header existing = {};
+    LARGE_INTEGER size = {};
+    DWORD read = 0;
+    HANDLE file = CreateFileA(imagePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    bool valid = file != INVALID_HANDLE_VALUE &&
+        ReadFile(file, &existing, sizeof(existing), &read, nullptr) && read == sizeof(existing) &&
+        existing.magic == kMagic && existing.version == kVersion;
+    if (valid && !reparsed && existing.tsv == tsvSig && existing.names == namesSig &&
+        existing.encoding == (uint32_t)encoding) {
+        CloseHandle(file);
+        return;
+    }
+    bool append = valid && GetFileSizeEx(file, &size) && size.QuadPart < 2 * (LONGLONG)existing.compactSize;
+
+    int stored = 0;
+    for (const FileBlock* block : blocks) {
+        if (block->stored.imageId == 0) continue;
+        if (block->stored.imageId != existing.id) append = false;
+        stored++;
+    }
+    if (stored == 0) append = false;
+
+    if (!append) {
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+
+        // Blocks still reading from the old image keep it mapped, and a mapped file
+        // can't be replaced - so bring both snapshots' blocks in first
+        if (previous) {
+            previous->globalNames->GetShard();
+            for (const auto& block : previous->files) block->GetShard();
+        }
+    }
+
+    uint64_t imageId = existing.id;
+    if (!append) {
+        FILETIME now;
+        GetSystemTimeAsFileTime(&now);
+        imageId = (((uint64_t)now.dwHighDateTime << 32) | now.dwLowDateTime) | 1;  // Never 0
+    }
+    uint32_t segmentOffset = append ? (uint32_t)((size.QuadPart + 7) & ~7ll) : Writer::FullSegmentOffset();
+
+    Writer writer;
+
+    // Blocks written into this segment, with their owner value (= directory index)
+    std::vector<std::pair<const FileBlock*, uint32_t>> written;
+    std::vector<const Shard*> shards;
+    std::vector<BlockRecord> blockRecords;
+    blockRecords.reserve(blocks.size());
+    for (uint32_t i = 0; i < (uint32_t)blocks.size(); i++) {
+        const FileBlock* block = blocks[i];
+        BlockRecord record;
+        if (append && block->stored.imageId == imageId) {
+            record = block->stored.record;
+        } else {
+            record = { {}, block->hash, block->counts, segmentOffset, i, {} };
+            written.emplace_back(block, i);
+            shards.push_back(&block->GetShard());
+        }
+        record.fileId = writer.AddString(block->fileId);
+        blockRecords.push_back(record);
+    }
+
+    auto setRange = [&](Section section, size_t w, size_t first, size_t end) {
+        blockRecords[written[w].second].ranges[section] = { (uint32_t)first, (uint32_t)(end - first) };
+    };
+
+    // tableOf(w) -> the section's table in the w-th written block
+    auto addKeyed = [&](Section section, auto tableOf) {
+        std::vector<KeyedRecord> records;
+        for (size_t w = 0; w < written.size(); w++) {
+            size_t first = records.size();
+            for (const Translation& entry : *tableOf(w)) {
+                records.push_back({ written[w].second, writer.AddString(entry.Original()),
+                    writer.AddString(entry.Text()), writer.AddString(entry.sjisKey) });
+            }
+            setRange(section, w, first, records.size());
+        }
+        writer.SetSection(section, records);
+    };
+
+    addKeyed(kNames, [&](size_t w) { return &written[w].first->names; });
+    addKeyed(kContextualNames, [&](size_t w) { return &shards[w]->contextualNames; });
+    addKeyed(kMessages, [&](size_t w) { return &shards[w]->messages; });
+    addKeyed(kLabels, [&](size_t w) { return &written[w].first->labels; });
+
+    std::vector<IntRecord> indexRecords;
+    std::vector<IndexedRecord> labelRecords;
+    std::vector<LineRecord> lineRecords;
+    std::vector<uint64_t> keyRecords;
+    for (size_t w = 0; w < written.size(); w++) {
+        const FileBlock* block = written[w].first;
+        uint32_t owner = written[w].second;
+
+        size_t first = indexRecords.size();
+        for (const Translation& entry : shards[w]->messages) {
+            if (entry.index >= 0) indexRecords.push_back({ owner, writer.AddString(entry.Original()), entry.index });
+        }
+        setRange(kMessageToIndex, w, first, indexRecords.size());
+
+        first = labelRecords.size();
+        for (const auto& label : block->sceneLabels) {
+            labelRecords.push_back({ owner, label.index, writer.AddString(label.name) });
+        }
+        setRange(kLabelsByIndex, w, first, labelRecords.size());
+
+        first = lineRecords.size();
+        for (const auto& line : shards[w]->lines) {
+            lineRecords.push_back({ owner, line.index, writer.AddString(line.translation->Original()),
+                writer.AddString(line.translation->Text()) });
+        }
+        setRange(kLines, w, first, lineRecords.size());
+
+        first = keyRecords.size();
+        keyRecords.insert(keyRecords.end(), block->messageKeys.begin(), block->messageKeys.end());
+        setRange(kMessageKeys, w, first, keyRecords.size());
+    }
+    writer.SetSection(kMessageToIndex, indexRecords);
+    writer.SetSection(kLabelsByIndex, labelRecords);
+    writer.SetSection(kLines, lineRecords);
+    writer.SetSection(kMessageKeys, keyRecords);
+    writer.SetSection(kBlocks, blockRecords);
+
+    Header header = append ? existing : Header{};
+    header.tsv = tsvSig;
+    header.names = namesSig;
+    header.encoding = (uint32_t)encoding;
+    header.id = imageId;
+
+    bool ok = append ? writer.Append(file, segmentOffset, header) : writer.Save(imagePath, header);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+    if (!ok) {
+        Log("[TL] Failed to write binary cache: %s\n", imagePath.c_str());
+        return;
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)blocks.size(); i++) blocks[i]->stored = { imageId, blockRecords[i] };
+    if (append) {
+        Log("[TL] Appended %d of %d blocks to binary cache: %s\n", (int)written.size(), (int)blocks.size(),
+            imagePath.c_str());
+    } else {
+        Log("[TL] Wrote binary cache: %s\n", imagePath.c_str());
+    }
+}
+
+//-----------------------------------------------------------------------------
+// TranslationDB - coverage
+//-----------------------------------------------------------------------------
+// Distinct message texts of a resident shard that were shown; a repeated
+// original with a translation of its own counts toward the same text
+static int CountShownTexts(const TranslationDB::Shard& shard) {
+    std::unordered_set<std::string_view> shownLines;
+    for (const TranslationDB::Translation& translation : shard.lineOverrides) {
+        if (translation.hits.load(std::memory_order_relaxed)) shownLines.insert(translation.Original());
+    }
+
+    int shown = 0;
+    for (const TranslationDB::Translation& translation : shard.messages) {
+        if (translation.sjisKey.empty()) continue;
+        if (translation.hits.load(std::memory_order_relaxed) || shownLines.count(translation.Original())) shown++;
+    }
+    return shown;
+}
+
+// Snapshot order; scenes without rows that were still visited go last
+std::vector<TranslationDB::SceneCoverage> TranslationDB::Coverage() {
+    std::vector<SceneCoverage> scenes;
+    std::unordered_map<std::string, size_t> byFile;
+
+    {
+        EpochDomain::Guard guard(m_epochs);
+        if (const Snapshot* snap = Current()) {
+            scenes.reserve(snap->files.size());
+            for (const BlockPtr& block : snap->files) {
+                // A shard nobody read yet has shown nothing
+                int hit = block->IsResident() ? CountShownTexts(block->GetShard()) : 0;
+                byFile.emplace(block->fileId, scenes.size());
+                scenes.push_back({ block->fileId, hit, (int)block->messageKeys.size(), 0.0 });
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> slock(m_statsMutex);
+    auto addTime = [&](const std::string& fileId, ULONGLONG ms) {
+        auto it = byFile.find(fileId);
+        if (it == byFile.end()) {
+            it = byFile.emplace(fileId, scenes.size()).first;
+            scenes.push_back({ fileId, 0, 0, 0.0 });
+        }
+        scenes[it->second].seconds += ms / 1000.0;
+    };
+    for (const auto& [fileId, ms] : m_sceneMs) addTime(fileId, ms);
+    if (!m_sceneFile.empty()) addTime(m_sceneFile, GetTickCount64() - m_sceneSince);
+    return scenes;
+}
+
+void TranslationDB::PrintCoverage() {
+    std::vector<SceneCoverage> scenes = Coverage();
+
+    Log("\n========== Scene Coverage ==========\n");
+    Log("  %-16s %15s %10s\n", "scene", "texts shown", "time");
+
+    int visited = 0, hit = 0, total = 0;
+    for (const SceneCoverage& scene : scenes) {
+        hit += scene.hit;
+        total += scene.total;
+        if (scene.hit == 0 && scene.seconds == 0.0) continue;  // The CSV lists these too
+
+        visited++;
+        int seconds = (int)scene.seconds;
+        Log("  %-16s %7d / %-5d %6dm%02ds\n", scene.fileId.c_str(), scene.hit, scene.total,
+            seconds / 60, seconds % 60);
+    }
+
+    Log("  %d of %d scenes visited, %d of %d texts shown (%.1f%%)\n",
+        visited, (int)scenes.size(), hit, total, total ? 100.0 * hit / total : 0.0);
+    Log("====================================\n\n");
+}
+
+bool TranslationDB::WriteCoverageCsv(const char* path) {
+    std::vector<SceneCoverage> scenes = Coverage();
+
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "w") != 0 || !f) return false;
+
+    fprintf(f, "scene,texts_shown,texts_total,coverage_pct,seconds\n");
+    for (const SceneCoverage& scene : scenes) {
+        fprintf(f, "%s,%d,%d,%.1f,%.1f\n", scene.fileId.c_str(), scene.hit, scene.total,
+            scene.total ? 100.0 * scene.hit / scene.total : 0.0, scene.seconds);
+    }
+    fclose(f);
+    return true;
+}
+
+//=============================================================================
+// Rendered Output Cache
+//=============================================================================
+namespace Render {
+    constexpr uint32_t kPlainWidth = 0xFFFF;  // Converted only, no normalize/wrap
+
+    inline uint32_t MakeKey(int width) {
+        return (g_stringPool.Generation() << 16) | ((uint32_t)width & 0xFFFF);
+    }
+
+    // Dialogue: normalize -> SJIS -> word wrap
+    const char* Message(const TranslationDB::Translation& translation) {
+        uint32_t key = MakeKey(Config::wordWrapWidth);
+        if (const char* cached = translation.GetRendered(key)) return cached;
+
+        // Reused per thread; the wrap below copies out of it
+        static thread_local std::string sjis;
+        sjis.clear();
+        Encoding::AppendUtf8ToSjis(sjis, TextFix::NormalizeUtf8(translation.Text()));
+        if (sjis.empty()) return nullptr;
+
+        const char* stored = g_stringPool.Store(WordWrap::Wrap(sjis, Config::wordWrapWidth));
+        translation.SetRendered(stored, key);
+        return stored;
+    }
+
+    // Names, choices, labels: straight SJIS conversion
+    const char* Plain(const TranslationDB::Translation& translation) {
+        uint32_t key = MakeKey(kPlainWidth);
+        if (const char* cached = translation.GetRendered(key)) return cached;
+
+        static thread_local std::string sjis;
+        sjis.clear();
+        Encoding::AppendUtf8ToSjis(sjis, translation.Text());
+        if (sjis.empty()) return nullptr;
+
+        const char* stored = g_stringPool.Store(sjis);
+        translation.SetRendered(stored, key);
+        return stored;
+    }
+
+    // Unlike the SJIS forms this doesn't depend on the wrap width or the string
+    // pool, so it lives on the entry itself for as long as the block does
+    const wchar_t* Wide(const TranslationDB::Translation& translation) {
+        if (const wchar_t* cached = translation.wide.load(std::memory_order_acquire)) return cached;
+
+        std::string_view text = translation.Text();
+        int length = text.empty() ? 0 : MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), nullptr, 0);
+        wchar_t* wide = new wchar_t[length + 1];
+        if (length > 0) MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), wide, length);
+        wide[length] = L'\0';
+
+        // Two threads may race to fill it; the loser keeps the winner's copy
+        const wchar_t* expected = nullptr;
+        if (!translation.wide.compare_exchange_strong(expected, wide, std::memory_order_acq_rel)) {
+            delete[] wide;
+            return expected;
+        }
+        return wide;
+    }
+}
+
@@ -0,0 +1,1398 @@
+#pragma once
+// RLD scripts, the binary translation image and the translation database the
+// hooks look lines up in, plus rendering translations to game-ready SJIS
+#include "text.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+//=============================================================================
+// RLD Script - decryption and command parsing (port of RLD_Decryptor.py)
+//=============================================================================
+// Only MESSAGE commands are kept, tagged with their command index - the same
+// INDEX column translation.tsv was extracted with - plus the scenes the script
+// can hand over to. JUMP targets are labels within the same file, so only
+// CHANGESCENARIO names another scene.
+namespace RldScript {
+    struct Message {
+        int index;         // Command index within the script
+        std::string text;  // CP932, the form the game hands to say()/printEx()
+    };
+
+    struct Script {
+        std::vector<Message> messages;
+        std::vector<std::string> successors;  // CHANGESCENARIO targets as fileIds, first use order
+    };
+
+    // Parse a decrypted script
+    bool Parse(const std::string& data, Script& script);
+
+    // Read, decrypt and parse an .rld file
+    bool Load(const char* path, Script& script);
+}
+
+//=============================================================================
+// Translation Image - binary cache of a parsed translation.tsv
+//=============================================================================
+// Layout: Header | segment | segment | ...
+// A segment is SegmentHeader | section records | string blob. The first one is
+// written with the whole image; a reload that reparsed a few blocks appends one
+// holding just those blocks plus a new block table (directory), then re-points
+// the header at it, so a one-line edit writes one block rather than the script.
+// All strings are stored once per segment (UTF-8, unescaped, NUL-terminated) and
+// referenced by offset, so loading is a straight copy into the lookup tables.
+// Keyed tables also carry the CP932 form of each key for the SJIS indexes.
+// Every record names the block it belongs to by its BlockRecord's owner; block 0
+// of a directory is unique_names.tsv. Each block's records are contiguous per
+// section of its segment and its BlockRecord holds the ranges, so one block's
+// messages can be read without walking the others.
+namespace TranslationImage {
+    constexpr uint32_t kMagic = 0x4E424C54;  // "TLBN"
+    constexpr uint32_t kVersion = 6;
+
+    // Source file identity - the image is only used while both still match
+    struct Signature {
+        uint64_t size;
+        uint64_t writeTime;
+
+        bool operator==(const Signature& other) const {
+            return size == other.size && writeTime == other.writeTime;
+        }
+        bool operator!=(const Signature& other) const { return !(*this == other); }
+    };
+
+    struct Counts {
+        int32_t globalNames;
+        int32_t contextualNames;
+        int32_t texts;
+        int32_t choices;
+        int32_t labels;
+    };
+
+    enum Section : uint32_t {
+        kBlocks,                // BlockRecord
+        kNames,                 // KeyedRecord
+        kContextualNames,       // KeyedRecord
+        kMessages,              // KeyedRecord
+        kLabels,                // KeyedRecord
+        kMessageToIndex,        // IntRecord
+        kLabelsByIndex,         // IndexedRecord
+        kLines,                 // LineRecord
+        kMessageKeys,           // uint64_t - FNV-1a of each kMessages CP932 key, same order
+        kSectionCount
+    };
+
+    struct StrRef { uint32_t offset; uint32_t length; };
+    struct Range { uint32_t first; uint32_t count; };
+    struct BlockRecord {
+        StrRef fileId;      // In the directory's segment
+        uint64_t hash;
+        Counts counts;
+        uint32_t segment;   // File offset of the SegmentHeader holding the block's records
+        uint32_t owner;     // The block value those records carry
+        Range ranges[kSectionCount];
+    };
+    struct KeyedRecord { uint32_t block; StrRef key; StrRef value; StrRef sjisKey; };
+    struct IntRecord { uint32_t block; StrRef key; int32_t value; };
+    struct IndexedRecord { uint32_t block; int32_t index; StrRef value; };
+    struct LineRecord { uint32_t block; int32_t index; StrRef original; StrRef value; };
+
+    struct SectionEntry { uint32_t offset; uint32_t count; };  // offset is from the start of the file
+
+    struct SegmentHeader {
+        SectionEntry sections[kSectionCount];
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        Signature tsv;
+        Signature names;
+        uint32_t encoding;
+        uint32_t directory;    // Segment whose kBlocks section is the live block table
+        uint64_t id;           // New for every full rewrite; appends keep it
+        uint32_t compactSize;  // File size right after the last full rewrite
+    };
+
+    inline Signature GetSignature(const char* path) {
+        Signature sig = {};
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (path && GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+            sig.size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+            sig.writeTime = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) |
+                data.ftLastWriteTime.dwLowDateTime;
+        }
+        return sig;
+    }
+
+    // Collects one segment's records + deduplicated strings, then writes it as a
+    // whole new image (atomically) or appends it to the existing one
+    class Writer {
+    public:
+        StrRef AddString(std::string_view s) {
+            auto it = m_offsets.find(s);
+            if (it != m_offsets.end()) return { it->second, (uint32_t)s.size() };
+
+            StrRef ref = { (uint32_t)m_strings.size(), (uint32_t)s.size() };
+            m_strings.append(s.data(), s.size());
+            m_strings.push_back('\0');
+            m_offsets.emplace(s, ref.offset);
+            return ref;
+        }
+
+        template <typename Record>
+        void SetSection(Section section, const std::vector<Record>& records) {
+            m_sections[section].assign((const char*)records.data(), records.size() * sizeof(Record));
+            m_counts[section] = (uint32_t)records.size();
+        }
+
+        // Where the segment will start: right after the header, or at the end of the image
+        static uint32_t FullSegmentOffset() { return (uint32_t)sizeof(Header); }
+
+        // Write to a temp file first so a crash never leaves a torn image
+        bool Save(const std::string& path, Header header) {
+            header.magic = kMagic;
+            header.version = kVersion;
+            header.directory = FullSegmentOffset();
+            std::string segment = Build(header.directory);
+            header.compactSize = header.directory + (uint32_t)segment.size();
+
+            std::string tmpPath = path + ".tmp";
+            {
+                std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+                if (!file) return false;
+                file.write((const char*)&header, sizeof(header));
+                file.write(segment.data(), segment.size());
+                if (!file) return false;
+            }
+            return MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+        }
+
+        // Blocks still reading from the image keep it mapped, so it is extended in
+        // place. The header is rewritten last: a crash before then leaves it
+        // pointing at the previous directory, with the new bytes unreferenced.
+        bool Append(HANDLE file, uint32_t offset, Header header) {
+            header.directory = offset;
+            std::string segment = Build(offset);
+
+            LARGE_INTEGER position;
+            position.QuadPart = offset;
+            DWORD written = 0;
+            if (!SetFilePointerEx(file, position, nullptr, FILE_BEGIN) ||
+                !WriteFile(file, segment.data(), (DWORD)segment.size(), &written, nullptr) ||
+                written != segment.size() || !FlushFileBuffers(file)) {
+                return false;
+            }
+
+            position.QuadPart = 0;
+            return SetFilePointerEx(file, position, nullptr, FILE_BEGIN) &&
+                WriteFile(file, &header, sizeof(header), &written, nullptr) && written == sizeof(header);
+        }
+
+    private:
+        std::string Build(uint32_t offset) const {
+            SegmentHeader segment = {};
+            uint32_t cursor = offset + (uint32_t)sizeof(SegmentHeader);
+            for (uint32_t i = 0; i < kSectionCount; i++) {
+                segment.sections[i] = { cursor, m_counts[i] };
+                cursor += (uint32_t)m_sections[i].size();
+            }
+            segment.stringsOffset = cursor;
+            segment.stringsSize = (uint32_t)m_strings.size();
+
+            std::string bytes((const char*)&segment, sizeof(segment));
+            for (const auto& section : m_sections) bytes += section;
+            bytes += m_strings;
+            return bytes;
+        }
+
+        std::unordered_map<std::string_view, uint32_t> m_offsets;  // views into the source tables
+        std::string m_strings;
+        std::string m_sections[kSectionCount];
+        uint32_t m_counts[kSectionCount] = {};
+    };
+
+    // Read-only memory-mapped image. The file may grow while it is open (see
+    // Writer::Append); this view keeps reading the directory it was opened with.
+    class View {
+    public:
+        ~View() { Close(); }
+
+        bool Open(const char* path) {
+            m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart < (LONGLONG)sizeof(Header) ||
+                size.QuadPart > 0x7FFFFFFF) {
+                return false;
+            }
+            m_size = (size_t)size.QuadPart;
+
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping) return false;
+
+            m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (!m_data) return false;
+
+            // A copy - appends rewrite the header underneath us
+            m_header = *(const Header*)m_data;
+            if (m_header.magic != kMagic || m_header.version != kVersion) return false;
+            return GetSegment(m_header.directory, m_directory);
+        }
+
+        void Close() {
+            if (m_data) UnmapViewOfFile(m_data);
+            if (m_mapping) CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+            m_data = nullptr;
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+        }
+
+        const Header& GetHeader() const { return m_header; }
+
+        // onBlock(index, record, fileId) is called for each block of the directory, in order
+        template <typename Fn>
+        bool ReadBlocks(Fn onBlock) const {
+            const SectionEntry& entry = m_directory.sections[kBlocks];
+            uint32_t count = 0;
+            const BlockRecord* records = GetRecords<BlockRecord>(m_directory, kBlocks, { 0, entry.count }, count);
+            if (!records) return false;
+
+            std::string_view fileId;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!GetString(m_directory, records[i].fileId, fileId)) return false;
+                if (!onBlock(i, records[i], fileId)) return false;
+            }
+            return true;
+        }
+
+        // One block's keyed table: onRecord(block, key, value, sjisKey)
+        template <typename Fn>
+        bool ReadKeyed(const BlockRecord& block, Section section, Fn onRecord) const {
+            SegmentHeader segment;
+            uint32_t count = 0;
+            const KeyedRecord* records = GetBlockRecords<KeyedRecord>(block, section, segment, count);
+            if (!records) return false;
+
+            std::string_view key, value, sjisKey;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!GetString(segment, records[i].key, key) || !GetString(segment, records[i].value, value) ||
+                    !GetString(segment, records[i].sjisKey, sjisKey)) {
+                    return false;
+                }
+                if (!onRecord(records[i].block, key, value, sjisKey)) return false;
+            }
+            return true;
+        }
+
+        // onRecord(block, key, value)
+        template <typename Fn>
+        bool ReadInts(const BlockRecord& block, Section section, Fn onRecord) const {
+            SegmentHeader segment;
+            uint32_t count = 0;
+            const IntRecord* records = GetBlockRecords<IntRecord>(block, section, segment, count);
+            if (!records) return false;
+
+            std::string_view key;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!GetString(segment, records[i].key, key)) return false;
+                if (!onRecord(records[i].block, key, (int)records[i].value)) return false;
+            }
+            return true;
+        }
+
+        // onRecord(block, index, value); records were written in index order per block
+        template <typename Fn>
+        bool ReadIndexed(const BlockRecord& block, Section section, Fn onRecord) const {
+            SegmentHeader segment;
+            uint32_t count = 0;
+            const IndexedRecord* records = GetBlockRecords<IndexedRecord>(block, section, segment, count);
+            if (!records) return false;
+
+            std::string_view value;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!GetString(segment, records[i].value, value)) return false;
+                if (!onRecord(records[i].block, (int)records[i].index, value)) return false;
+            }
+            return true;
+        }
+
+        // onRecord(block, index, original, value); in index order per block
+        template <typename Fn>
+        bool ReadLines(const BlockRecord& block, Fn onRecord) const {
+            SegmentHeader segment;
+            uint32_t count = 0;
+            const LineRecord* records = GetBlockRecords<LineRecord>(block, kLines, segment, count);
+            if (!records) return false;
+
+            std::string_view original, value;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!GetString(segment, records[i].original, original) ||
+                    !GetString(segment, records[i].value, value)) {
+                    return false;
+                }
+                if (!onRecord(records[i].block, (int)records[i].index, original, value)) return false;
+            }
+            return true;
+        }
+
+        // onHash(hash) - message key hashes only, no strings are touched
+        template <typename Fn>
+        bool ReadHashes(const BlockRecord& block, Fn onHash) const {
+            SegmentHeader segment;
+            uint32_t count = 0;
+            const uint64_t* records = GetBlockRecords<uint64_t>(block, kMessageKeys, segment, count);
+            if (!records) return false;
+
+            for (uint32_t i = 0; i < count; i++) onHash(records[i]);
+            return true;
+        }
+
+    private:
+        bool GetSegment(uint32_t offset, SegmentHeader& out) const {
+            if ((uint64_t)offset + sizeof(SegmentHeader) > m_size) return false;
+            memcpy(&out, m_data + offset, sizeof(out));
+            return (uint64_t)out.stringsOffset + out.stringsSize <= m_size;
+        }
+
+        template <typename Record>
+        const Record* GetRecords(const SegmentHeader& segment, Section section, const Range& range,
+            uint32_t& count) const {
+            const SectionEntry& entry = segment.sections[section];
+            if ((uint64_t)entry.offset + (uint64_t)entry.count * sizeof(Record) > m_size) return nullptr;
+            if ((uint64_t)range.first + range.count > entry.count) return nullptr;
+            count = range.count;
+            return (const Record*)(m_data + entry.offset) + range.first;
+        }
+
+        template <typename Record>
+        const Record* GetBlockRecords(const BlockRecord& block, Section section, SegmentHeader& segment,
+            uint32_t& count) const {
+            if (!GetSegment(block.segment, segment)) return nullptr;
+            return GetRecords<Record>(segment, section, block.ranges[section], count);
+        }
+
+        bool GetString(const SegmentHeader& segment, const StrRef& ref, std::string_view& out) const {
+            if ((uint64_t)ref.offset + ref.length >= segment.stringsSize) return false;
+            out = std::string_view(m_data + segment.stringsOffset + ref.offset, ref.length);
+            return true;
+        }
+
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+        Header m_header = {};
+        SegmentHeader m_directory = {};
+    };
+}
+
+//=============================================================================
+// Epoch-Based Reclamation
+//=============================================================================
+// Readers pin the current epoch while they touch shared data; writers retire
+// superseded objects and free them once no pinned reader can still see them.
+// Pinning is two uncontended atomic stores - readers never block.
+class EpochDomain {
+public:
+    static constexpr int kMaxReaders = 64;
+
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) : m_domain(domain) { m_domain.Enter(); }
+        ~Guard() { m_domain.Exit(); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochDomain& m_domain;
+    };
+
+    ~EpochDomain() {
+        // Process teardown - nobody is reading any more
+        for (auto& item : m_retired) item.deleter();
+    }
+
+    // Defer deletion of an object that has already been unpublished
+    void Retire(std::function<void()> deleter) {
+        std::lock_guard<std::mutex> lock(m_retireMutex);
+        uint64_t epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        m_retired.push_back({ epoch, std::move(deleter) });
+    }
+
+    // Free what no reader can still reference; returns how many are still pending
+    size_t Reclaim() {
+        std::lock_guard<std::mutex> lock(m_retireMutex);
+        if (m_retired.empty()) return 0;
+        if (m_overflowReaders.load(std::memory_order_seq_cst) != 0) return m_retired.size();
+
+        uint64_t oldestActive = UINT64_MAX;
+        for (const auto& slot : m_slots) {
+            uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < oldestActive) oldestActive = epoch;
+        }
+
+        size_t kept = 0;
+        for (auto& item : m_retired) {
+            if (item.epoch < oldestActive) {
+                item.deleter();
+            } else {
+                m_retired[kept++] = std::move(item);
+            }
+        }
+        m_retired.resize(kept);
+        return kept;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};  // 0 = not reading
+        int depth = 0;                   // Only touched by the owning thread
+    };
+
+    struct RetiredItem {
+        uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    // Process-wide id per live thread, handed back on thread exit for the next
+    // thread to reuse. Only threads past kMaxReaders at once share the overflow counter.
+    class ReaderIds {
+    public:
+        int Acquire() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_free.empty()) {
+                int id = m_free.back();
+                m_free.pop_back();
+                return id;
+            }
+            return (m_next < kMaxReaders) ? m_next++ : kMaxReaders;
+        }
+
+        void Release(int id) {
+            if (id >= kMaxReaders) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(id);
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<int> m_free;
+        int m_next = 0;
+    };
+
+    static ReaderIds& Ids() {
+        static ReaderIds s_ids;
+        return s_ids;
+    }
+
+    // A thread exits outside any Guard, so its slot is already idle in every domain
+    struct ThreadReader {
+        int id = Ids().Acquire();
+        ~ThreadReader() { Ids().Release(id); }
+    };
+
+    static int ReaderId() {
+        static thread_local ThreadReader t_reader;
+        return t_reader.id;
+    }
+
+    void Enter() {
+        int id = ReaderId();
+        if (id >= kMaxReaders) {
+            m_overflowReaders.fetch_add(1, std::memory_order_seq_cst);
+            return;
+        }
+        Slot& slot = m_slots[id];
+        if (slot.depth++ == 0) {
+            slot.epoch.store(m_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        }
+    }
+
+    void Exit() {
+        int id = ReaderId();
+        if (id >= kMaxReaders) {
+            m_overflowReaders.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        Slot& slot = m_slots[id];
+        if (--slot.depth == 0) {
+            slot.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    Slot m_slots[kMaxReaders];
+    std::atomic<uint64_t> m_epoch{1};
+    std::atomic<int> m_overflowReaders{0};
+    std::vector<RetiredItem> m_retired;
+    std::mutex m_retireMutex;
+};
+
+//=============================================================================
+// Translation Database
+//=============================================================================
+// Scene tracking globals
+extern std::mutex g_sceneMutex;
+extern std::string g_currentFile;
+extern std::string g_currentLabel;
+extern std::atomic<const void*> g_currentScene;  // Block/label that last set the two above
+
+// DumpUntranslated: misses are queued with the scene they happened in and a
+// background thread appends them to Config::untranslatedLog in batches
+namespace MissDump {
+    void Start();   // Opens the dump file and starts the writer; no-op unless dumpUntranslated
+    void Post(std::string_view utf8Text, const char* type);  // Once per (type, text); type is a literal
+    void Stop();    // Writes what is queued and closes the file - safe from DllMain
+}
+
+class TranslationDB {
+public:
+    // Game-ready SJIS output cached on an entry; key records how it was rendered
+    struct RenderSlot {
+        const char* sjis;
+        uint32_t key;
+    };
+
+    // One row of an EntryTable: its strings (in the table's arena) plus the lookup
+    // state resolved at load and the lazily filled render caches
+    struct Translation {
+        static constexpr int32_t kNoScene = -2;  // Not a scene line (choices, names, labels)
+        static constexpr int32_t kNoLabel = -1;  // Scene line before the block's first label
+
+        // Speaker-specific name for this line (contextual NAME rows)
+        struct Speaker {
+            std::string_view sjisName;
+            const Translation* name;
+        };
+
+        ~Translation() { delete[] wide.load(std::memory_order_relaxed); }
+
+        // UTF-8; NUL-terminated, so data() can go straight to a C string API
+        std::string_view Original() const { return original; }
+        std::string_view Text() const { return text; }
+
+        const char* GetRendered(uint32_t key) const {
+            RenderSlot slot = rendered.load(std::memory_order_acquire);
+            return (slot.sjis && slot.key == key) ? slot.sjis : nullptr;
+        }
+
+        void SetRendered(const char* sjis, uint32_t key) const {
+            rendered.store(RenderSlot{ sjis, key }, std::memory_order_release);
+        }
+
+        std::string_view original;
+        std::string_view text;
+        std::string_view sjisKey;  // CP932 lookup key; empty if the row isn't looked up by one
+        int32_t index = -1;        // Script position of a TEXT row
+        int32_t label = kNoScene;  // Owning label in the entry's block, resolved at load
+        std::vector<Speaker> speakers;  // Resolved at load; usually empty or one
+        mutable std::atomic<RenderSlot> rendered{ RenderSlot{ nullptr, 0 } };
+        mutable std::atomic<uint32_t> hits{0};  // Message lookups that returned this entry
+        mutable std::atomic<const wchar_t*> wide{nullptr};  // UTF-16 form, owned; see Render::Wide
+    };
+
+    // Open-addressing hash of 32-bit ids. The keys stay with the caller, which maps
+    // an id back to its key; each slot keeps the key's hash so a probe rarely needs
+    // to. Linear probing, power-of-two capacity, never more than half full.
+    class FlatIndex {
+    public:
+        static constexpr uint32_t kNone = UINT32_MAX;
+
+        void Reserve(size_t count) {
+            if (count == 0) return;
+            size_t capacity = 16;
+            while (capacity < count * 2) capacity *= 2;
+            if (capacity > m_slots.size()) Rehash(capacity);
+        }
+
+        // keyOf(id) -> the std::string_view stored under id
+        template <typename KeyOf>
+        uint32_t Find(std::string_view key, uint32_t hash, KeyOf keyOf) const {
+            if (m_slots.empty()) return kNone;
+
+            size_t mask = m_slots.size() - 1;
+            for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                const Slot& slot = m_slots[i];
+                if (slot.id == kNone) return kNone;
+                if (slot.hash == hash && keyOf(slot.id) == key) return slot.id;
+            }
+        }
+
+        // Adds id under key, unless the key is already there - then returns the id it has
+        template <typename KeyOf>
+        uint32_t Insert(std::string_view key, uint32_t hash, uint32_t id, KeyOf keyOf) {
+            if ((m_size + 1) * 2 > m_slots.size()) Rehash(std::max<size_t>(16, m_slots.size() * 2));
+
+            size_t mask = m_slots.size() - 1;
+            for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                Slot& slot = m_slots[i];
+                if (slot.id == kNone) {
+                    slot = { hash, id };
+                    m_size++;
+                    return kNone;
+                }
+                if (slot.hash == hash && keyOf(slot.id) == key) return slot.id;
+            }
+        }
+
+        size_t Size() const { return m_size; }
+
+    private:
+        struct Slot {
+            uint32_t hash;
+            uint32_t id;
+        };
+
+        // Keys are distinct already, so only the hashes are looked at
+        void Rehash(size_t capacity) {
+            std::vector<Slot> slots(capacity, Slot{ 0, kNone });
+            size_t mask = capacity - 1;
+            for (const Slot& slot : m_slots) {
+                if (slot.id == kNone) continue;
+                size_t i = slot.hash & mask;
+                while (slots[i].id != kNone) i = (i + 1) & mask;
+                slots[i] = slot;
+            }
+            m_slots.swap(slots);
+        }
+
+        std::vector<Slot> m_slots;
+        size_t m_size = 0;
+    };
+
+    // One table of rows (names, labels, messages, ...): the entries in one array,
+    // every string they point at in one arena, and flat hashes of entry ids over the
+    // CP932 keys and the UTF-8 originals. Filled while the owning block is built,
+    // then sealed; only the build may touch it after that.
+    class EntryTable {
+    public:
+        // A parsed row. A repeated original replaces the earlier row's translation
+        // (and index, if one is given), as the TSV always has. Keyed at Seal.
+        void Set(std::string_view original, std::string_view translated, int index = -1);
+
+        // A row read back from the image, with the CP932 key it was written with
+        void Append(std::string_view original, std::string_view translated, std::string_view sjisKey);
+
+        // The image keeps script indexes in a section of their own
+        void SetIndex(std::string_view original, int index);
+
+        // Lay the rows out in the arena and index them; the staging copies go away
+        void Seal();
+
+        const Translation* Find(std::string_view sjis) const { return Find(sjis, HashBytes(kHashSeed, sjis)); }
+        const Translation* Find(std::string_view sjis, uint64_t hash) const;  // hash = HashBytes of sjis
+        const Translation* FindOriginal(std::string_view utf8) const;
+        Translation* FindOriginal(std::string_view utf8);  // Only while the owning block is still being built
+
+        size_t Size() const { return m_size; }            // Every row
+        size_t KeyCount() const { return m_byKey.Size(); }  // Rows with a CP932 key
+
+        const Translation* begin() const { return m_entries.get(); }
+        const Translation* end() const { return m_entries.get() + m_size; }
+        Translation* begin() { return m_entries.get(); }
+        Translation* end() { return m_entries.get() + m_size; }
+
+    private:
+        struct Row {
+            std::string original;
+            std::string translated;
+            std::string sjisKey;
+            int32_t index;
+            bool convertKey;  // Parsed rows get their CP932 key at Seal
+        };
+
+        std::string_view OriginalOf(uint32_t id) const {
+            return m_entries ? m_entries[id].original : std::string_view(m_rows[id].original);
+        }
+
+        std::vector<Row> m_rows;                   // Until Seal
+        std::unique_ptr<char[]> m_arena;           // Every string, NUL-terminated
+        std::unique_ptr<Translation[]> m_entries;  // Row order
+        size_t m_size = 0;
+        FlatIndex m_byKey;                         // CP932 key -> entry
+        FlatIndex m_byOriginal;                    // UTF-8 original -> entry (first of equal originals)
+    };
+
+    // Everything parsed from one fileId's rows of translation.tsv (or from the whole
+    // of unique_names.tsv). Immutable once built, and shared between snapshots for as
+    // long as its source lines hash the same - unchanged entries keep their render cache.
+    // Names, labels and message key hashes are always resident; the per-message data
+    // lives in a shard that a block loaded from the binary cache reads on first use.
+    struct FileBlock {
+        struct SceneLabel {
+            int index;
+            std::string name;     // As shown in [SCENE] logs
+            std::string chapter;  // Without the " [N]" suffix, for Discord
+        };
+
+        // A TEXT row at its script position. Repeated originals each keep their own
+        // translation (and scene) here, while messages only holds the last one.
+        struct ScriptLine {
+            int index;
+            int32_t label;                   // As Translation::label, but for this position
+            const Translation* translation;  // Into messages, or lineOverrides if it differs
+        };
+
+        // The block's TEXT, CHOICE and contextual NAME rows
+        struct Shard {
+            void Seal();
+            void AddLine(int index, std::string_view original, std::string_view translated);
+            void ResolveScenes(const std::vector<SceneLabel>& sceneLabels);
+            void ResolveSpeakers();
+            void ResolveLines(const std::vector<SceneLabel>& sceneLabels);
+            const ScriptLine* FindLine(int index) const;
+
+            EntryTable contextualNames;           // "name|message" -> translated_name
+            EntryTable messages;                  // message -> translated; index = its TEXT row
+            EntryTable lineOverrides;             // Rows that differ from messages, in line order
+            std::vector<ScriptLine> lines;        // Sorted by index
+        };
+
+        // Where a shard that hasn't been read yet lives
+        struct ShardSource {
+            std::shared_ptr<const TranslationImage::View> image;
+            TranslationImage::BlockRecord record;
+        };
+
+        // Where the image on disk keeps this block, so a later save can point its
+        // new directory at the records instead of writing them again
+        struct Stored {
+            uint64_t imageId = 0;  // TranslationImage::Header::id; 0 = in no image
+            TranslationImage::BlockRecord record = {};
+        };
+
+        void AddLabel(int index, std::string_view name);
+        void Seal();
+        void SetShard(std::unique_ptr<Shard> shard);
+        void SetSource(ShardSource source) { m_source = std::move(source); }
+        const Shard& GetShard() const;
+        bool IsResident() const { return m_shard.load(std::memory_order_acquire) != nullptr; }
+        const ScriptLine* FindLine(int index) const { return GetShard().FindLine(index); }
+
+        std::string fileId;                                            // Empty for unique_names.tsv
+        uint64_t hash = 0;                                             // Of the block's source lines
+        TranslationImage::Counts counts = {};
+        EntryTable names;                                              // name -> translated (fallback)
+        EntryTable labels;                                             // label -> translated
+        std::vector<SceneLabel> sceneLabels;                           // Sorted by index
+        std::vector<uint64_t> messageKeys;                             // HashBytes of each shard message key
+        mutable Stored stored;                                         // Loaders only, under m_reloadMutex
+
+    private:
+        std::unique_ptr<Shard> ReadShard() const;
+
+        mutable std::mutex m_shardMutex;                // Serializes the first GetShard()
+        mutable std::atomic<const Shard*> m_shard{nullptr};
+        mutable std::unique_ptr<Shard> m_ownedShard;
+        mutable ShardSource m_source;                   // Released once the shard is read
+    };
+
+    using BlockPtr = std::shared_ptr<const FileBlock>;
+    using Shard = FileBlock::Shard;
+
+    // Snapshot-wide CP932 lookup over every block; later blocks override earlier ones
+    class MergedIndex {
+    public:
+        struct Hit {
+            const Translation* translation;
+            const FileBlock* block;
+        };
+
+        void Reserve(size_t count) {
+            m_items.reserve(count);
+            m_index.Reserve(count);
+        }
+
+        void Merge(const EntryTable& table, const FileBlock* block) {
+            for (const Translation& translation : table) {
+                if (!translation.sjisKey.empty()) Set(translation.sjisKey, Hit{ &translation, block });
+            }
+        }
+
+        void Set(std::string_view key, const Hit& hit) {
+            uint32_t id = m_index.Insert(key, (uint32_t)HashBytes(kHashSeed, key), (uint32_t)m_items.size(), KeyOf{ this });
+            if (id != FlatIndex::kNone) {
+                m_items[id].hit = hit;
+            } else {
+                m_items.push_back({ key, hit });
+            }
+        }
+
+        const Hit* Find(std::string_view sjis) const {
+            uint32_t id = m_index.Find(sjis, (uint32_t)HashBytes(kHashSeed, sjis), KeyOf{ this });
+            return (id != FlatIndex::kNone) ? &m_items[id].hit : nullptr;
+        }
+
+        size_t Size() const { return m_items.size(); }
+
+        template <typename Fn>
+        void ForEach(Fn fn) const {
+            for (const Item& item : m_items) fn(item.key, item.hit);
+        }
+
+    private:
+        struct Item {
+            std::string_view key;  // Lives in a block's EntryTable arena
+            Hit hit;
+        };
+
+        struct KeyOf {
+            const MergedIndex* index;
+            std::string_view operator()(uint32_t id) const { return index->m_items[id].key; }
+        };
+
+        std::vector<Item> m_items;
+        FlatIndex m_index;
+    };
+
+    // Snapshot-wide message lookup that needs no shard resident until a key hits:
+    // CP932 key hash -> owning block, later blocks overriding earlier ones
+    class MessageDirectory {
+    public:
+        void Build(const std::vector<BlockPtr>& files);
+        MergedIndex::Hit Find(std::string_view sjis) const;
+        size_t Size() const { return m_slots.size(); }
+
+    private:
+        struct Slot {
+            uint64_t hash;
+            const FileBlock* block;
+        };
+
+        std::vector<Slot> m_slots;  // Sorted by hash, one per key
+    };
+
+    // One published state of the database. Built privately, then never modified.
+    struct Snapshot {
+        bool Load(const char* tsvPath, const char* namesPath, const Snapshot* previous);
+        BlockPtr FindBlock(const std::string& fileId) const;
+
+        BlockPtr globalNames;            // unique_names.tsv
+        std::vector<BlockPtr> files;     // translation.tsv, in order of first appearance
+        MergedIndex names;
+        MessageDirectory messages;
+        MergedIndex labels;
+        MergedIndex labelBases;          // "label" -> lowest-numbered "label [N]"
+
+    private:
+        void Link();
+        void LinkLabelBases();
+        static bool SplitLabelSuffix(std::string_view label, std::string_view& base, int& number);
+        bool LoadImage(const std::string& imagePath,
+            const TranslationImage::Signature& tsvSig, const TranslationImage::Signature& namesSig,
+            const char* tsvPath, const char* namesPath);
+        void SaveImage(const std::string& imagePath,
+            const TranslationImage::Signature& tsvSig, const TranslationImage::Signature& namesSig,
+            Encoding::Type encoding, const Snapshot* previous, bool reparsed) const;
+        TranslationImage::Counts TotalCounts() const;
+        static BlockPtr ParseNames(std::string_view utf8Content, uint64_t hash);
+        static BlockPtr ParseBlock(const std::string& fileId, uint64_t hash,
+            const std::vector<const Tsv::Row*>& rows);
+    };
+
+    // Pin the published snapshot. Pointers returned by the Find* calls stay
+    // valid for as long as a ReadGuard is alive on the calling thread.
+    class ReadGuard {
+    public:
+        explicit ReadGuard(TranslationDB& db) : m_guard(db.m_epochs) {}
+
+    private:
+        EpochDomain::Guard m_guard;
+    };
+
+    ~TranslationDB() {
+        delete m_current.load(std::memory_order_relaxed);
+    }
+
+    // Free retired snapshots no reader still has pinned; returns how many are left
+    size_t Reclaim() { return m_epochs.Reclaim(); }
+
+    // Parse into a fresh snapshot without touching the live one, then swap it in.
+    // Blocks whose source lines did not change are carried over from the live snapshot.
+    bool Load(const char* tsvPath, const char* namesPath) {
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+
+        // Only loaders retire snapshots, so the live one is safe to read here
+        const Snapshot* previous = m_current.load(std::memory_order_acquire);
+
+        std::unique_ptr<Snapshot> snapshot(new Snapshot());
+        bool ok = snapshot->Load(tsvPath, namesPath, previous);
+
+        // Re-point the scene's positions at the new blocks before the old ones can go
+        if (std::shared_ptr<const ScenePositions> scene = std::atomic_load(&m_scene)) {
+            BindScene(snapshot.get(), scene->fileId, scene->script, scene->cursor.load(std::memory_order_relaxed));
+        }
+        Publish(snapshot.release());
+
+        // Scene keys point into blocks that may have just been freed
+        g_currentScene.store(nullptr, std::memory_order_relaxed);
+        return ok;
+    }
+
+    // Bumped by every publish, so callers can tell a cached answer is stale
+    uint32_t LoadGeneration() const { return m_loadGeneration.load(std::memory_order_acquire); }
+
+    void Reload() {
+        Log("[TL] Reloading...\n");
+        Load(Config::translationFile, Config::namesFile);
+    }
+
+    // Told the chapter name each time a line moves playback into a new label;
+    // set once before any lookups
+    using ChapterListener = void (*)(const std::string& chapter);
+    void SetChapterListener(ChapterListener listener) { m_chapterListener = listener; }
+
+    // Place the running scene's lines by script position; called off the game thread
+    void SetSceneScript(const std::string& fileId, std::shared_ptr<const RldScript::Script> script) {
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+        BindScene(m_current.load(std::memory_order_acquire), fileId, std::move(script), 0);
+    }
+
+    // Fall back to text matching until the next scene's script is bound
+    void ClearSceneScript() {
+        std::atomic_store(&m_scene, std::shared_ptr<const ScenePositions>());
+    }
+
+    // Read the shards of scenes the running one may hand over to, so the game
+    // thread doesn't have to when it gets there; called off the game thread
+    void Prefetch(const std::vector<std::string>& fileIds) {
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+        const Snapshot* snap = m_current.load(std::memory_order_acquire);
+        if (!snap) return;
+
+        int loaded = 0;
+        for (const std::string& fileId : fileIds) {
+            BlockPtr block = snap->FindBlock(fileId);
+            if (!block || block->IsResident()) continue;
+            block->GetShard();
+            loaded++;
+        }
+        if (loaded > 0) Log("[TL] Prefetched %d of %d next scenes\n", loaded, (int)fileIds.size());
+    }
+
+    void FindInDB(const std::string& searchText) {
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+        if (!snap) return;
+
+        int found = 0;
+        Log("\n[SEARCH] Looking for: %s\n", searchText.c_str());
+
+        // Reads every shard - fine for a debug command, never done from a hook
+        for (const auto& block : snap->files) {
+            for (const Translation& entry : block->GetShard().messages) {
+                std::string_view key = entry.Original();
+                std::string_view val = entry.Text();
+                if (key.find(searchText) != std::string_view::npos ||
+                    val.find(searchText) != std::string_view::npos) {
+                    Log("  [%s] -> [%s]\n",
+                        std::string(key.substr(0, 40)).c_str(),
+                        std::string(val.substr(0, 40)).c_str());
+                    found++;
+                    if (found >= Constants::kMaxSearchResults) {
+                        Log("  ... (showing first %d)\n", Constants::kMaxSearchResults);
+                        break;
+                    }
+                }
+            }
+            if (found >= Constants::kMaxSearchResults) break;
+        }
+
+        if (found == 0) {
+            Log("  No matches found.\n");
+        }
+        Log("\n");
+    }
+
+    // A spoken line: the translated message plus the name to show with it
+    struct Line {
+        const Translation* name;
+        const Translation* message;
+    };
+
+    // Message and speaker in one message hash; the name falls back to global names
+    Line LookupLine(const char* sjisName, const char* sjisMessage) {
+        Line line = { nullptr, nullptr };
+
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+        if (!snap) return line;
+
+        Match match;
+        bool found = MatchMessage(snap, sjisMessage, match);
+        if (found) line.message = match.translation;
+
+        if (sjisName && *sjisName) {
+            // Try contextual lookup first (name + message)
+            if (found && !match.translation->speakers.empty()) {
+                std::string_view name(sjisName);
+                for (const auto& speaker : match.translation->speakers) {
+                    if (speaker.sjisName == name) {
+                        line.name = speaker.name;
+                        break;
+                    }
+                }
+            }
+
+            if (!line.name) line.name = MatchName(snap, sjisName);
+        }
+
+        return line;
+    }
+
+    // Global name lookup (CharID-only lines have no message context)
+    const Translation* FindNameTranslation(const char* sjisName) {
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+        return snap ? MatchName(snap, sjisName) : nullptr;
+    }
+
+    const Translation* FindMessageTranslation(const char* sjisMessage) {
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+        if (!snap) return nullptr;
+
+        Match match;
+        return MatchMessage(snap, sjisMessage, match) ? match.translation : nullptr;
+    }
+
+    // Simple lookup for UI elements (dialogs, buttons) - no logging or tracking
+    const Translation* FindUITranslation(const char* sjisText) {
+        if (!sjisText || !*sjisText) return nullptr;
+
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+        if (!snap) return nullptr;
+
+        return snap->messages.Find(sjisText).translation;
+    }
+
+    // Label
+    const Translation* FindLabelTranslation(const char* sjisLabel) {
+        if (!sjisLabel || !*sjisLabel) return nullptr;
+
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+        if (!snap) return nullptr;
+
+        // Try exact match first
+        const MergedIndex::Hit* hit = snap->labels.Find(sjisLabel);
+        if (hit) {
+            return hit->translation;
+        }
+
+        // Save files don't include [X] suffix, but TSV does
+        hit = snap->labelBases.Find(sjisLabel);
+        if (hit) {
+            return hit->translation;
+        }
+
+        if (Config::dumpUntranslated) {
+            LogMissing(Encoding::SjisToUtf8(sjisLabel).c_str(), "LABEL");
+        }
+        return nullptr;
+    }
+
+    std::atomic<int> m_hitCount{0};
+    std::atomic<int> m_missCount{0};
+    std::atomic<int> m_positionHits{0};  // Hits placed by script position rather than text
+    std::mutex m_statsMutex;
+
+    // One fileId of the live snapshot (or a scene with no rows, like the title):
+    // distinct message texts shown since its block was loaded, and time spent in it
+    struct SceneCoverage {
+        std::string fileId;
+        int hit;
+        int total;
+        double seconds;
+    };
+
+    // Called when playback moves to another scene, from either tracking source
+    void NoteScene(const std::string& fileId) {
+        std::lock_guard<std::mutex> slock(m_statsMutex);
+        if (fileId == m_sceneFile) return;
+
+        ULONGLONG now = GetTickCount64();
+        if (!m_sceneFile.empty()) m_sceneMs[m_sceneFile] += now - m_sceneSince;
+        m_sceneFile = fileId;
+        m_sceneSince = now;
+    }
+
+    std::vector<SceneCoverage> Coverage();
+    void PrintCoverage();
+    bool WriteCoverageCsv(const char* path);
+
+    void PrintStats() {
+        EpochDomain::Guard guard(m_epochs);
+        const Snapshot* snap = Current();
+
+        int scenesVisited = 0, textsMatched = 0, textsTotal = 0;
+        for (const SceneCoverage& scene : Coverage()) {
+            if (scene.hit > 0) scenesVisited++;
+            textsMatched += scene.hit;
+            textsTotal += scene.total;
+        }
+
+        std::lock_guard<std::mutex> slock(m_statsMutex);
+
+        Log("\n========== Translation Stats ==========\n");
+        Log("  Loaded: %d messages, %d labels, %d names\n",
+            snap ? (int)snap->messages.Size() : 0,
+            snap ? (int)snap->labels.Size() : 0,
+            snap ? (int)snap->names.Size() : 0);
+        if (snap) {
+            int resident = 0;
+            for (const auto& block : snap->files) resident += block->IsResident() ? 1 : 0;
+            Log("  Resident scenes: %d of %d\n", resident, (int)snap->files.size());
+        }
+        Log("  Hits: %d | Misses: %d\n", m_hitCount.load(), m_missCount.load());
+        Log("  Placed by script position: %d\n", m_positionHits.load());
+        Log("  Unique texts matched: %d of %d, in %d scenes ('coverage' for the breakdown)\n",
+            textsMatched, textsTotal, scenesVisited);
+
+        // Show missed texts (game sent but not in TSV)
+        if (!m_missedHashes.empty()) {
+            Log("\n--- Missed (game sent, not in TSV): ---\n");
+            for (const auto& text : m_missedSamples) {
+                Log("  %s\n", text.substr(0, 70).c_str());
+            }
+            if (m_missedHashes.size() > m_missedSamples.size()) {
+                Log("  ... +%d more\n", (int)(m_missedHashes.size() - m_missedSamples.size()));
+            }
+        } else {
+            Log("\n  No missed texts! Everything translated.\n");
+        }
+
+        Log("=========================================\n\n");
+    }
+
+private:
+    // Caller must hold an EpochDomain::Guard on m_epochs
+    const Snapshot* Current() const {
+        return m_current.load(std::memory_order_seq_cst);
+    }
+
+    const Translation* MatchName(const Snapshot* snap, const char* sjisName) {
+        if (!sjisName || !*sjisName) return nullptr;
+
+        const MergedIndex::Hit* hit = snap->names.Find(sjisName);
+        if (hit) {
+            return hit->translation;
+        }
+
+        if (Config::dumpUntranslated) {
+            LogMissing(Encoding::SjisToUtf8(sjisName).c_str(), "NAME");
+        }
+        return nullptr;
+    }
+
+    // Every MESSAGE command of the running scene, bound to the TSV row at the same
+    // (fileId, index). Immutable apart from the playback cursor.
+    struct ScenePositions {
+        std::string fileId;
+        std::shared_ptr<const RldScript::Script> script;
+        BlockPtr block;                                        // Keeps the lines alive past a reload
+        std::vector<const FileBlock::ScriptLine*> lines;       // Parallel to script->messages; null = no TSV row
+        std::unordered_map<std::string_view, std::vector<uint32_t>> byText;  // Cue positions, ascending
+        mutable std::atomic<uint32_t> cursor{0};               // Cue after the last one shown
+    };
+
+    // Resolved message plus where it sits, for scene tracking
+    struct Match {
+        const Translation* translation;
+        const FileBlock* block;
+        int32_t label;
+    };
+
+    // Caller holds m_reloadMutex, so snap cannot be retired underneath us
+    void BindScene(const Snapshot* snap, const std::string& fileId,
+        std::shared_ptr<const RldScript::Script> script, uint32_t cursor) {
+        auto scene = std::make_shared<ScenePositions>();
+        scene->fileId = fileId;
+        scene->script = std::move(script);
+        scene->cursor.store(cursor, std::memory_order_relaxed);
+
+        if (snap) scene->block = snap->FindBlock(fileId);
+
+        // FindLine reads the block's shard the first time, here rather than on the game thread
+        const std::vector<RldScript::Message>& messages = scene->script->messages;
+        int placed = 0;
+        scene->lines.reserve(messages.size());
+        scene->byText.reserve(messages.size());
+        for (uint32_t i = 0; i < (uint32_t)messages.size(); i++) {
+            const FileBlock::ScriptLine* line = scene->block ? scene->block->FindLine(messages[i].index) : nullptr;
+            scene->lines.push_back(line);
+            scene->byText[messages[i].text].push_back(i);
+            if (line) placed++;
+        }
+
+        Log("[TL] Scene %s: %d of %d lines placed by position\n", fileId.c_str(), placed, (int)messages.size());
+        std::atomic_store(&m_scene, std::shared_ptr<const ScenePositions>(std::move(scene)));
+    }
+
+    // The cue after the last one shown costs one compare; a repeat of the current
+    // line, a jump or a backlog replay costs one scene-local hash
+    bool MatchPosition(const char* sjisMessage, Match& match) {
+        std::shared_ptr<const ScenePositions> scene = std::atomic_load(&m_scene);
+        if (!scene || !scene->block) return false;
+
+        const std::vector<RldScript::Message>& script = scene->script->messages;
+        uint32_t next = scene->cursor.load(std::memory_order_relaxed);
+        uint32_t cue;
+        if (next < script.size() && script[next].text == sjisMessage) {
+            cue = next;
+        } else if (next > 0 && next <= script.size() && script[next - 1].text == sjisMessage) {
+            cue = next - 1;
+        } else {
+            auto it = scene->byText.find(sjisMessage);
+            if (it == scene->byText.end()) return false;
+
+            // Nearest occurrence ahead of the cursor, else the last one behind it
+            const std::vector<uint32_t>& cues = it->second;
+            auto ahead = std::lower_bound(cues.begin(), cues.end(), next);
+            cue = (ahead != cues.end()) ? *ahead : cues.back();
+        }
+        scene->cursor.store(cue + 1, std::memory_order_relaxed);
+
+        const FileBlock::ScriptLine* line = scene->lines[cue];
+        if (!line) return false;
+
+        // Scenes are rebound before a snapshot is published, so the one owning this
+        // block is either live or retired after our guard pinned it
+        match = { line->translation, scene->block.get(), line->label };
+        m_positionHits++;
+        return true;
+    }
+
+    // Message lookup with hit/miss stats and scene tracking
+    bool MatchMessage(const Snapshot* snap, const char* sjisMessage, Match& match) {
+        if (!sjisMessage || !*sjisMessage) return false;
+
+        bool found = MatchPosition(sjisMessage, match);
+        if (!found) {
+            MergedIndex::Hit hit = snap->messages.Find(sjisMessage);
+            if (hit.translation) {
+                match = { hit.translation, hit.block, hit.translation->label };
+                found = true;
+            }
+        }
+
+        if (found) {
+            m_hitCount++;
+            match.translation->hits.fetch_add(1, std::memory_order_relaxed);
+
+            // Track current scene from the label resolved at load - one compare unless it changed
+            const FileBlock* block = match.block;
+            int32_t label = match.label;
+            if (label != Translation::kNoScene) {
+                const FileBlock::SceneLabel* scene = (label >= 0) ? &block->sceneLabels[label] : nullptr;
+                const void* sceneKey = scene ? (const void*)scene : (const void*)block;
+
+                if (g_currentScene.exchange(sceneKey, std::memory_order_relaxed) != sceneKey) {
+                    {
+                        std::lock_guard<std::mutex> sceneLock(g_sceneMutex);
+                        g_currentFile = block->fileId;
+                        g_currentLabel = scene ? scene->name : std::string();
+                    }
+                    NoteScene(block->fileId);
+                    if (scene) {
+                        Log(LogCategory::Scene, "[SCENE] %s | %s\n", block->fileId.c_str(), scene->name.c_str());
+                        // Update Discord Presence with current label
+                        if (m_chapterListener) m_chapterListener(scene->chapter);
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // Miss - only now pay for the UTF-8 conversion (stats + dump)
+        std::string utf8Key = Encoding::SjisToUtf8(sjisMessage);
+        if (utf8Key.empty()) return false;
+
+        m_missCount++;
+        {
+            // Distinct misses are counted by hash; only the first few keep their text
+            std::lock_guard<std::mutex> slock(m_statsMutex);
+            if (m_missedHashes.insert(HashBytes(kHashSeed, utf8Key)).second &&
+                m_missedSamples.size() < Constants::kMaxMissedTextsToShow) {
+                m_missedSamples.push_back(utf8Key);
+            }
+        }
+
+        LogMissing(utf8Key.c_str(), "TEXT");
+        return false;
+    }
+
+    // Swap in a new snapshot; the old one is freed once no reader still has it pinned
+    void Publish(Snapshot* snapshot) {
+        Snapshot* old = m_current.exchange(snapshot, std::memory_order_seq_cst);
+        m_loadGeneration.fetch_add(1, std::memory_order_release);
+        if (!old) return;
+
+        // Readers only pin for the length of one hook call, so this usually frees it
+        // at once; if not, the service thread keeps calling Reclaim until it does
+        m_epochs.Retire([old]() { delete old; });
+        m_epochs.Reclaim();
+    }
+
+    static const char* EncodingName(Encoding::Type encoding) {
+        switch (encoding) {
+            case Encoding::Type::UTF8_BOM: return "UTF-8 (BOM)";
+            case Encoding::Type::UTF8: return "UTF-8";
+            case Encoding::Type::ShiftJIS: return "Shift-JIS";
+            default: return "Unknown";
+        }
+    }
+
+    static void LogLoaded(const char* source, const TranslationImage::Counts& counts,
+        const char* tsvPath, const char* namesPath) {
+        Log("[TL] Loaded (%s):\n", source);
+        Log("[TL]   %d global names (from %s)\n", counts.globalNames, namesPath ? namesPath : "none");
+        Log("[TL]   %d contextual names (from %s)\n", counts.contextualNames, tsvPath);
+        Log("[TL]   %d texts\n", counts.texts);
+        Log("[TL]   %d choices\n", counts.choices);
+        Log("[TL]   %d labels\n", counts.labels);
+    }
+
+    void LogMissing(const char* utf8Text, const char* type) {
+        if (!Config::dumpUntranslated) return;
+        MissDump::Post(utf8Text, type);
+    }
+
+    std::atomic<Snapshot*> m_current{nullptr};
+    std::atomic<uint32_t> m_loadGeneration{0};
+    EpochDomain m_epochs;
+    std::mutex m_reloadMutex;  // Serializes loaders only; readers never take it
+    std::shared_ptr<const ScenePositions> m_scene;  // Swapped with atomic_load/atomic_store
+    std::unordered_set<uint64_t> m_missedHashes;  // Under m_statsMutex
+    std::unordered_map<std::string, ULONGLONG> m_sceneMs;  // Time in scenes left so far, ditto
+    std::string m_sceneFile;                      // Scene being timed
+    ULONGLONG m_sceneSince = 0;
+    std::vector<std::string> m_missedSamples;     // First kMaxMissedTextsToShow of them
+    ChapterListener m_chapterListener = nullptr;
+};
+
+//=============================================================================
+// Rendered Output Cache
+//=============================================================================
+// Each translation remembers its final game-ready SJIS buffer (interned in
+// g_stringPool). The key packs the pool generation with the wrap width it was
+// rendered for, so a pool clear or a width change simply misses.
+namespace Render {
+    // Dialogue: normalize -> SJIS -> word wrap
+    const char* Message(const TranslationDB::Translation& translation);
+
+    // Names, choices, labels: straight SJIS conversion
+    const char* Plain(const TranslationDB::Translation& translation);
+
+    // Window and dialog text: UTF-16 for the W APIs, converted once per entry
+    const wchar_t* Wide(const TranslationDB::Translation& translation);
+}
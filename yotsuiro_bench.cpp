@@ -0,0 +1,230 @@
+// Offline benchmark for the text pipeline: loads a translation.tsv the way the
+// hook does, then replays SJIS lines through the same path as AdvCharSay_Hook
+// (lookup -> normalize -> convert -> wrap -> intern) and reports the cost.
+//
+//   yotsuiro_bench <translation.tsv> [options]
+//     --names <file>   unique_names.tsv (default: none)
+//     --lines <file>   CP932 lines to replay, "message" or "name<TAB>message" per line
+//                      (default: every TEXT row of the TSV, in file order)
+//     --passes <n>     Replay the stream n times (default 3; pass 1 renders, later ones hit the cache)
+//     --wrap <n>       Word wrap width (default 70)
+#include "translation_db.h"
+#include <Psapi.h>
+#include <chrono>
+#include <cstdlib>
+
+#pragma comment(lib, "psapi.lib")
+
+//=============================================================================
+// Helpers
+//=============================================================================
+struct ReplayLine {
+    std::string name;     // CP932, may be empty
+    std::string message;  // CP932
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static bool ReadText(const char* path, std::string& content) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    content.assign((size_t)file.tellg(), '\0');
+    file.seekg(0);
+    file.read(&content[0], content.size());
+    return (bool)file;
+}
+
+// Calls fn(line) for each line, without the line break
+template <typename Fn>
+static void ForEachLine(const std::string& text, Fn fn) {
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+
+        std::string_view line(text.data() + start, end - start);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        fn(line);
+        start = end + 1;
+    }
+}
+
+// The TSV's own TEXT rows, with the NAME row at the same index as the speaker.
+// Read and split with the core's TSV code, so these are the rows the hook parsed.
+static bool LinesFromTsv(const char* tsvPath, std::vector<ReplayLine>& lines) {
+    TextFile file;
+    if (!file.Open(tsvPath)) return false;
+
+    std::string_view pendingFile, pendingIndex;
+    std::string pendingName;
+    for (const Tsv::Row& row : Tsv::ReadRows(file.Text())) {
+        if (row.fieldCount < 4) continue;
+        std::string_view type = row.fields[2];
+
+        bool sameLine = row.fields[0] == pendingFile && row.fields[1] == pendingIndex;
+        if (type == "NAME") {
+            pendingFile = row.fields[0];
+            pendingIndex = row.fields[1];
+            pendingName = Encoding::Utf8ToSjis(Tsv::Unescape(row.fields[3]).c_str());
+        } else if (type == "TEXT" || type == "MSG") {
+            std::string message = Encoding::Utf8ToSjis(Tsv::Unescape(row.fields[3]).c_str());
+            if (message.empty()) continue;
+            lines.push_back({ sameLine ? pendingName : std::string(), std::move(message) });
+        }
+    }
+    return true;
+}
+
+// The loads run on a copy in %TEMP%, so the cache they write (<tsv>.bin) never
+// lands beside the user's file and one left from an earlier run is never read
+static bool MakeScratchCopy(const char* tsvPath, std::string& scratchPath) {
+    char tempDir[MAX_PATH];
+    DWORD length = GetTempPathA(MAX_PATH, tempDir);
+    if (length == 0 || length >= MAX_PATH) return false;
+
+    char path[MAX_PATH];
+    sprintf_s(path, "%syotsuiro_bench_%lu.tsv", tempDir, GetCurrentProcessId());
+    scratchPath = path;
+    DeleteFileA((scratchPath + ".bin").c_str());
+    return CopyFileA(tsvPath, path, FALSE) != 0;
+}
+
+static bool LinesFromFile(const char* path, std::vector<ReplayLine>& lines) {
+    std::string content;
+    if (!ReadText(path, content)) return false;
+
+    ForEachLine(content, [&](std::string_view line) {
+        if (line.empty()) return;
+        size_t tab = line.find('\t');
+        if (tab == std::string_view::npos) {
+            lines.push_back({ std::string(), std::string(line) });
+        } else {
+            lines.push_back({ std::string(line.substr(0, tab)), std::string(line.substr(tab + 1)) });
+        }
+    });
+    return true;
+}
+
+static void PrintLoad(const char* label, double seconds, uint64_t allocations) {
+    printf("  %-22s %9.1f ms  %12llu allocs\n", label, seconds * 1000.0, (unsigned long long)allocations);
+}
+
+// Load a fresh database; returns false if the TSV could not be read
+static bool TimeLoad(const char* label, const char* tsvPath, const char* namesPath, bool useCache,
+    std::unique_ptr<TranslationDB>& db) {
+    Config::useBinaryCache = useCache;
+    db = std::make_unique<TranslationDB>();
+
+    uint64_t allocations = AllocCount::Total();
+    Clock::time_point start = Clock::now();
+    bool ok = db->Load(tsvPath, namesPath);
+    PrintLoad(label, SecondsSince(start), AllocCount::Total() - allocations);
+    return ok;
+}
+
+//=============================================================================
+// Entry Point
+//=============================================================================
+int main(int argc, char** argv) {
+    const char* tsvPath = nullptr;
+    const char* namesPath = nullptr;
+    const char* linesPath = nullptr;
+    int passes = 3;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--names" && hasValue) namesPath = argv[++i];
+        else if (arg == "--lines" && hasValue) linesPath = argv[++i];
+        else if (arg == "--passes" && hasValue) passes = (std::max)(1, atoi(argv[++i]));
+        else if (arg == "--wrap" && hasValue) Config::wordWrapWidth = atoi(argv[++i]);
+        else if (!tsvPath && arg[0] != '-') tsvPath = argv[i];
+        else {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!tsvPath) {
+        fprintf(stderr, "Usage: yotsuiro_bench <translation.tsv> [--names <file>] [--lines <file>] "
+            "[--passes <n>] [--wrap <n>]\n");
+        return 2;
+    }
+
+    // Database logging goes to stderr so the report on stdout stays readable
+    Config::enableTextLogging = false;
+    Config::dumpUntranslated = false;
+    g_logFile = stderr;
+    AsyncLog::Start();
+
+    std::string scratchPath;
+    if (!MakeScratchCopy(tsvPath, scratchPath)) {
+        fprintf(stderr, "Cannot copy %s to the temp directory\n", tsvPath);
+        AsyncLog::Stop();
+        return 1;
+    }
+    auto removeScratch = [&]() {
+        DeleteFileA((scratchPath + ".bin").c_str());
+        DeleteFileA(scratchPath.c_str());
+    };
+
+    printf("\n=== Load ===\n");
+    std::unique_ptr<TranslationDB> db;
+    if (!TimeLoad("parse TSV", scratchPath.c_str(), namesPath, false, db)) {
+        fprintf(stderr, "Cannot load %s\n", tsvPath);
+        removeScratch();
+        AsyncLog::Stop();
+        return 1;
+    }
+    TimeLoad("parse + write cache", scratchPath.c_str(), namesPath, true, db);
+    TimeLoad("load from cache", scratchPath.c_str(), namesPath, true, db);
+
+    std::vector<ReplayLine> lines;
+    bool haveLines = linesPath ? LinesFromFile(linesPath, lines) : LinesFromTsv(tsvPath, lines);
+    if (!haveLines || lines.empty()) {
+        fprintf(stderr, "No lines to replay from %s\n", linesPath ? linesPath : tsvPath);
+        db.reset();
+        removeScratch();
+        AsyncLog::Stop();
+        return 1;
+    }
+
+    printf("\n=== Replay (%d lines, wrap %d) ===\n", (int)lines.size(), Config::wordWrapWidth);
+    for (int pass = 1; pass <= passes; pass++) {
+        int hits = 0;
+        uint64_t allocations = AllocCount::Total();
+        Clock::time_point start = Clock::now();
+
+        for (const ReplayLine& line : lines) {
+            TranslationDB::ReadGuard guard(*db);
+            TranslationDB::Line found = db->LookupLine(line.name.empty() ? nullptr : line.name.c_str(),
+                line.message.c_str());
+            if (found.name) Render::Plain(*found.name);
+            if (found.message && Render::Message(*found.message)) hits++;
+        }
+
+        double seconds = SecondsSince(start);
+        uint64_t used = AllocCount::Total() - allocations;
+        printf("  pass %d: %10.0f lines/s  %7.2f us/line  %6.2f allocs/line  %d/%d hit\n",
+            pass, seconds > 0 ? lines.size() / seconds : 0.0, seconds * 1e6 / lines.size(),
+            (double)used / lines.size(), hits, (int)lines.size());
+    }
+
+    PROCESS_MEMORY_COUNTERS memory = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory))) {
+        printf("\n=== Memory ===\n");
+        printf("  peak working set      %9.1f MB\n", memory.PeakWorkingSetSize / (1024.0 * 1024.0));
+        printf("  peak committed        %9.1f MB\n", memory.PeakPagefileUsage / (1024.0 * 1024.0));
+    }
+    printf("\n");
+
+    db.reset();  // Unmaps the cache so it can be deleted
+    removeScratch();
+    AsyncLog::Stop();
+    return 0;
+}